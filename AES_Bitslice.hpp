@@ -0,0 +1,615 @@
+#ifndef _CRYPTL_AES_BITSLICE_HPP_
+#define _CRYPTL_AES_BITSLICE_HPP_
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+#include <cryptl/BitwiseINT.hpp>
+#include <cryptl/CPU_Features.hpp>
+#include <cryptl/Wipe.hpp>
+
+#ifdef CRYPTL_X86_64
+#include <immintrin.h>
+#endif
+
+namespace cryptl {
+
+////////////////////////////////////////////////////////////////////////////////
+// bitsliced AES for unmanaged bytes
+//
+// Eight blocks at a time. The state is eight bit planes, plane b holds bit b
+// of all 128 octets. Octet k of a plane is that state octet of the eight
+// blocks, one bit per block. A plane is one SSE2 register on x86-64 and two
+// 64-bit words elsewhere (octets 0 to 7, then 8 to 15).
+//
+// SubBytes is a Boolean circuit, ShiftRows and MixColumns are shifts and
+// masks. There are no lookups indexed by data, so timing does not depend on
+// the key or the message.
+//
+
+template <typename VAR, typename T, typename U, typename BITWISE>
+class AES_Bitslice
+{
+public:
+    static const std::size_t BLOCKS = 8;
+
+    static bool enabled() { return false; }
+
+    typedef std::uint64_t WordType;
+
+    static void expandKey(const VAR*, const std::size_t, WordType*) {
+    }
+
+    static void encrypt(const VAR*,
+                        VAR*,
+                        const std::size_t,
+                        const WordType*,
+                        const std::size_t) {
+    }
+
+    static void decrypt(const VAR*,
+                        VAR*,
+                        const std::size_t,
+                        const WordType*,
+                        const std::size_t) {
+    }
+};
+
+template <>
+class AES_Bitslice<std::uint8_t,
+                   std::uint8_t,
+                   std::uint8_t,
+                   BitwiseINT<std::uint8_t>>
+{
+public:
+    static const std::size_t BLOCKS = 8;
+
+    static bool enabled() { return true; }
+
+#ifdef CRYPTL_X86_64
+    typedef __m128i WordType;
+#else
+    typedef std::uint64_t WordType;
+#endif
+
+    // words in the state and in each round key
+    static const std::size_t WORDS = 128 / sizeof(WordType);
+
+    // round keys as planes, WORDS * (Nr + 1) words from the AES_KeyExpansion
+    // schedule w of 16 * (Nr + 1) octets
+    static void expandKey(const std::uint8_t* w,
+                          const std::size_t Nr,
+                          WordType* rk)
+    {
+        // same octets in every block
+        std::uint8_t a[16 * BLOCKS];
+
+        for (std::size_t round = 0; round <= Nr; ++round) {
+            for (std::size_t j = 0; j < BLOCKS; ++j)
+                std::memcpy(a + 16 * j, w + 16 * round, 16);
+
+            pack(a, BLOCKS, rk + WORDS * round);
+        }
+
+        wipe(a);
+    }
+
+    // n is at most BLOCKS, rk is from expandKey()
+    static void encrypt(const std::uint8_t* in,
+                        std::uint8_t* out,
+                        const std::size_t n,
+                        const WordType* rk,
+                        const std::size_t Nr)
+    {
+        WordType q[WORDS];
+        pack(in, n, q);
+
+        AddRoundKey(q, rk);
+
+        for (std::size_t round = 1; round < Nr; ++round) {
+            SubBytes(q);
+            ShiftRows(q);
+            MixColumns(q);
+            AddRoundKey(q, rk + WORDS * round);
+        }
+
+        SubBytes(q);
+        ShiftRows(q);
+        AddRoundKey(q, rk + WORDS * Nr);
+
+        unpack(q, n, out);
+    }
+
+    // the inverse cipher with the same round keys as encrypt()
+    static void decrypt(const std::uint8_t* in,
+                        std::uint8_t* out,
+                        const std::size_t n,
+                        const WordType* rk,
+                        const std::size_t Nr)
+    {
+        WordType q[WORDS];
+        pack(in, n, q);
+
+        AddRoundKey(q, rk + WORDS * Nr);
+
+        for (std::size_t round = Nr - 1; round > 0; --round) {
+            InvShiftRows(q);
+            InvSubBytes(q);
+            AddRoundKey(q, rk + WORDS * round);
+            InvMixColumns(q);
+        }
+
+        InvShiftRows(q);
+        InvSubBytes(q);
+        AddRoundKey(q, rk);
+
+        unpack(q, n, out);
+    }
+
+private:
+    static void AddRoundKey(WordType* q, const WordType* rk) {
+        for (std::size_t i = 0; i < WORDS; ++i) q[i] ^= rk[i];
+    }
+
+    // Boyar and Peralta, "A depth-16 circuit for the AES S-box" (2011)
+    static void Sbox(WordType* q) {
+        const WordType
+            x0 = q[7], x1 = q[6], x2 = q[5], x3 = q[4],
+            x4 = q[3], x5 = q[2], x6 = q[1], x7 = q[0];
+
+        // top linear transformation
+        const WordType
+            y14 = x3 ^ x5,
+            y13 = x0 ^ x6,
+            y9 = x0 ^ x3,
+            y8 = x0 ^ x5,
+            t0 = x1 ^ x2,
+            y1 = t0 ^ x7,
+            y4 = y1 ^ x3,
+            y12 = y13 ^ y14,
+            y2 = y1 ^ x0,
+            y5 = y1 ^ x6,
+            y3 = y5 ^ y8,
+            t1 = x4 ^ y12,
+            y15 = t1 ^ x5,
+            y20 = t1 ^ x1,
+            y6 = y15 ^ x7,
+            y10 = y15 ^ t0,
+            y11 = y20 ^ y9,
+            y7 = x7 ^ y11,
+            y17 = y10 ^ y11,
+            y19 = y10 ^ y8,
+            y16 = t0 ^ y11,
+            y21 = y13 ^ y16,
+            y18 = x0 ^ y16;
+
+        // shared non-linear part, inversion in GF(2^8)
+        const WordType
+            t2 = y12 & y15,
+            t3 = y3 & y6,
+            t4 = t3 ^ t2,
+            t5 = y4 & x7,
+            t6 = t5 ^ t2,
+            t7 = y13 & y16,
+            t8 = y5 & y1,
+            t9 = t8 ^ t7,
+            t10 = y2 & y7,
+            t11 = t10 ^ t7,
+            t12 = y9 & y11,
+            t13 = y14 & y17,
+            t14 = t13 ^ t12,
+            t15 = y8 & y10,
+            t16 = t15 ^ t12,
+            t17 = t4 ^ t14,
+            t18 = t6 ^ t16,
+            t19 = t9 ^ t14,
+            t20 = t11 ^ t16,
+            t21 = t17 ^ y20,
+            t22 = t18 ^ y19,
+            t23 = t19 ^ y21,
+            t24 = t20 ^ y18,
+            t25 = t21 ^ t22,
+            t26 = t21 & t23,
+            t27 = t24 ^ t26,
+            t28 = t25 & t27,
+            t29 = t28 ^ t22,
+            t30 = t23 ^ t24,
+            t31 = t22 ^ t26,
+            t32 = t31 & t30,
+            t33 = t32 ^ t24,
+            t34 = t23 ^ t33,
+            t35 = t27 ^ t33,
+            t36 = t24 & t35,
+            t37 = t36 ^ t34,
+            t38 = t27 ^ t36,
+            t39 = t29 & t38,
+            t40 = t25 ^ t39,
+            t41 = t40 ^ t37,
+            t42 = t29 ^ t33,
+            t43 = t29 ^ t40,
+            t44 = t33 ^ t37,
+            t45 = t42 ^ t41,
+            z0 = t44 & y15,
+            z1 = t37 & y6,
+            z2 = t33 & x7,
+            z3 = t43 & y16,
+            z4 = t40 & y1,
+            z5 = t29 & y7,
+            z6 = t42 & y11,
+            z7 = t45 & y17,
+            z8 = t41 & y10,
+            z9 = t44 & y12,
+            z10 = t37 & y3,
+            z11 = t33 & y4,
+            z12 = t43 & y13,
+            z13 = t40 & y5,
+            z14 = t29 & y2,
+            z15 = t42 & y9,
+            z16 = t45 & y14,
+            z17 = t41 & y8;
+
+        // bottom linear transformation
+        const WordType
+            t46 = z15 ^ z16,
+            t47 = z10 ^ z11,
+            t48 = z5 ^ z13,
+            t49 = z9 ^ z10,
+            t50 = z2 ^ z12,
+            t51 = z2 ^ z5,
+            t52 = z7 ^ z8,
+            t53 = z0 ^ z3,
+            t54 = z6 ^ z7,
+            t55 = z16 ^ z17,
+            t56 = z12 ^ t48,
+            t57 = t50 ^ t53,
+            t58 = z4 ^ t46,
+            t59 = z3 ^ t54,
+            t60 = t46 ^ t57,
+            t61 = z14 ^ t57,
+            t62 = t52 ^ t58,
+            t63 = t49 ^ t58,
+            t64 = z4 ^ t59,
+            t65 = t61 ^ t62,
+            t66 = z1 ^ t63,
+            s0 = t59 ^ t63,
+            s6 = t56 ^ ~t62,
+            s7 = t48 ^ ~t60,
+            t67 = t64 ^ t65,
+            s3 = t53 ^ t66,
+            s4 = t51 ^ t66,
+            s5 = t47 ^ t65,
+            s1 = t64 ^ ~s3,
+            s2 = t55 ^ ~t67;
+
+        q[7] = s0; q[6] = s1; q[5] = s2; q[4] = s3;
+        q[3] = s4; q[2] = s5; q[1] = s6; q[0] = s7;
+    }
+
+    // inverse affine transformation of x XOR {63}
+    static void InvAffine(WordType* q) {
+        const WordType
+            q0 = ~q[0], q1 = ~q[1], q2 = q[2], q3 = q[3],
+            q4 = q[4], q5 = ~q[5], q6 = ~q[6], q7 = q[7];
+
+        q[0] = q2 ^ q5 ^ q7;
+        q[1] = q3 ^ q6 ^ q0;
+        q[2] = q4 ^ q7 ^ q1;
+        q[3] = q5 ^ q0 ^ q2;
+        q[4] = q6 ^ q1 ^ q3;
+        q[5] = q7 ^ q2 ^ q4;
+        q[6] = q0 ^ q3 ^ q5;
+        q[7] = q1 ^ q4 ^ q6;
+    }
+
+    // 5.1.1 SubBytes() Transformation
+    static void SubBytes(WordType* q) {
+        for (std::size_t h = 0; h < WORDS; h += 8)
+            Sbox(q + h);
+    }
+
+    // 5.3.2 InvSubBytes() Transformation
+    //
+    // the S-box is an affine map A of the inverse, so the inverse S-box is
+    // A^-1(S-box(A^-1(x))) with the same circuit
+    static void InvSubBytes(WordType* q) {
+        for (std::size_t h = 0; h < WORDS; h += 8) {
+            InvAffine(q + h);
+            Sbox(q + h);
+            InvAffine(q + h);
+        }
+    }
+
+#ifdef CRYPTL_X86_64
+    // exchange bits of a under mask with bits of b under mask << n
+    __attribute__((target("sse2")))
+    static void swapMove(WordType& a, WordType& b, const int n, const WordType mask) {
+        const WordType t = (_mm_srli_epi64(b, n) ^ a) & mask;
+        a ^= t;
+        b ^= _mm_slli_epi64(t, n);
+    }
+
+    // 8x8 bit matrix at each octet position, bit b of register j goes to
+    // bit j of register b
+    __attribute__((target("sse2")))
+    static void transpose(WordType* q) {
+        const WordType
+            m1 = _mm_set1_epi8(0x55),
+            m2 = _mm_set1_epi8(0x33),
+            m4 = _mm_set1_epi8(0x0f);
+
+        for (std::size_t j = 0; j < 8; j += 2) swapMove(q[j + 1], q[j], 1, m1);
+        for (std::size_t j = 0; j < 8; j += 4) {
+            swapMove(q[j + 2], q[j], 2, m2);
+            swapMove(q[j + 3], q[j + 1], 2, m2);
+        }
+        for (std::size_t j = 0; j < 4; ++j) swapMove(q[j + 4], q[j], 4, m4);
+    }
+
+    // block j in register j then transposed, missing blocks are zero
+    __attribute__((target("sse2")))
+    static void pack(const std::uint8_t* in, const std::size_t n, WordType* q) {
+        for (std::size_t j = 0; j < 8; ++j) {
+            q[j] = j < n
+                ? _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 16 * j))
+                : _mm_setzero_si128();
+        }
+
+        transpose(q);
+    }
+
+    __attribute__((target("sse2")))
+    static void unpack(const WordType* state, const std::size_t n, std::uint8_t* out) {
+        WordType q[8];
+        std::memcpy(q, state, sizeof(q));
+
+        transpose(q);
+
+        for (std::size_t j = 0; j < n; ++j)
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16 * j), q[j]);
+    }
+
+    // row r of a plane is octet r of each 32-bit column
+    __attribute__((target("sse2")))
+    static WordType row(const int r) {
+        return _mm_set1_epi32(0xff << (8 * r));
+    }
+
+    // 5.1.2 ShiftRows() Transformation
+    //
+    // row r rotates right by r columns
+    __attribute__((target("sse2")))
+    static void ShiftRows(WordType* q) {
+        for (std::size_t b = 0; b < 8; ++b) {
+            const WordType x = q[b];
+            q[b] = (x & row(0)) |
+                   (_mm_shuffle_epi32(x, 0x39) & row(1)) |
+                   (_mm_shuffle_epi32(x, 0x4e) & row(2)) |
+                   (_mm_shuffle_epi32(x, 0x93) & row(3));
+        }
+    }
+
+    // 5.3.1 InvShiftRows() Transformation
+    __attribute__((target("sse2")))
+    static void InvShiftRows(WordType* q) {
+        for (std::size_t b = 0; b < 8; ++b) {
+            const WordType x = q[b];
+            q[b] = (x & row(0)) |
+                   (_mm_shuffle_epi32(x, 0x93) & row(1)) |
+                   (_mm_shuffle_epi32(x, 0x4e) & row(2)) |
+                   (_mm_shuffle_epi32(x, 0x39) & row(3));
+        }
+    }
+
+    // rows up by one and two within each column
+    __attribute__((target("sse2")))
+    static WordType rotRow1(const WordType x) {
+        return _mm_srli_epi32(x, 8) | _mm_slli_epi32(x, 24);
+    }
+
+    __attribute__((target("sse2")))
+    static WordType rotRow2(const WordType x) {
+        return _mm_srli_epi32(x, 16) | _mm_slli_epi32(x, 16);
+    }
+#else
+    // 8x8 bit matrix, bit j of octet i goes to bit i of octet j
+    static std::uint64_t transpose(std::uint64_t x) {
+        std::uint64_t t;
+        t = (x ^ (x >> 7)) & 0x00aa00aa00aa00aa; x ^= t ^ (t << 7);
+        t = (x ^ (x >> 14)) & 0x0000cccc0000cccc; x ^= t ^ (t << 14);
+        t = (x ^ (x >> 28)) & 0x00000000f0f0f0f0; x ^= t ^ (t << 28);
+        return x;
+    }
+
+    // octet k of the eight blocks is a 64-bit word, missing blocks are zero
+    static void pack(const std::uint8_t* in, const std::size_t n, WordType* q) {
+        for (std::size_t i = 0; i < 16; ++i) q[i] = 0;
+
+        for (std::size_t k = 0; k < 16; ++k) {
+            std::uint64_t x = 0;
+            for (std::size_t j = 0; j < n; ++j)
+                x |= std::uint64_t(in[16 * j + k]) << (8 * j);
+
+            x = transpose(x);
+
+            for (std::size_t b = 0; b < 8; ++b)
+                q[8 * (k / 8) + b] |= ((x >> (8 * b)) & 0xff) << (8 * (k % 8));
+        }
+    }
+
+    static void unpack(const WordType* q, const std::size_t n, std::uint8_t* out) {
+        for (std::size_t k = 0; k < 16; ++k) {
+            std::uint64_t x = 0;
+            for (std::size_t b = 0; b < 8; ++b)
+                x |= ((q[8 * (k / 8) + b] >> (8 * (k % 8))) & 0xff) << (8 * b);
+
+            x = transpose(x);
+
+            for (std::size_t j = 0; j < n; ++j)
+                out[16 * j + k] = x >> (8 * j);
+        }
+    }
+
+    // row r of a plane is octet r of each 32-bit column
+    static WordType row(const int r) {
+        return 0x000000ff000000ffULL << (8 * r);
+    }
+
+    // 5.1.2 ShiftRows() Transformation
+    //
+    // row r rotates right by r columns as a 128-bit plane
+    static void ShiftRows(WordType* q) {
+        for (std::size_t b = 0; b < 8; ++b) {
+            const WordType lo = q[b], hi = q[8 + b];
+
+            q[b] = (lo & row(0)) |
+                   (((lo >> 32) | (hi << 32)) & row(1)) |
+                   (hi & row(2)) |
+                   (((lo << 32) | (hi >> 32)) & row(3));
+
+            q[8 + b] = (hi & row(0)) |
+                       (((hi >> 32) | (lo << 32)) & row(1)) |
+                       (lo & row(2)) |
+                       (((hi << 32) | (lo >> 32)) & row(3));
+        }
+    }
+
+    // 5.3.1 InvShiftRows() Transformation
+    static void InvShiftRows(WordType* q) {
+        for (std::size_t b = 0; b < 8; ++b) {
+            const WordType lo = q[b], hi = q[8 + b];
+
+            q[b] = (lo & row(0)) |
+                   (((lo << 32) | (hi >> 32)) & row(1)) |
+                   (hi & row(2)) |
+                   (((lo >> 32) | (hi << 32)) & row(3));
+
+            q[8 + b] = (hi & row(0)) |
+                       (((hi << 32) | (lo >> 32)) & row(1)) |
+                       (lo & row(2)) |
+                       (((hi >> 32) | (lo << 32)) & row(3));
+        }
+    }
+
+    // rows up by one and two within each column
+    static WordType rotRow1(const WordType x) {
+        return ((x >> 8) & 0x00ffffff00ffffffULL) | ((x << 24) & 0xff000000ff000000ULL);
+    }
+
+    static WordType rotRow2(const WordType x) {
+        return ((x >> 16) & 0x0000ffff0000ffffULL) | ((x << 16) & 0xffff0000ffff0000ULL);
+    }
+#endif
+
+    // {02} * x on eight planes
+    static void xtime(WordType* x) {
+        const WordType x7 = x[7];
+        x[7] = x[6];
+        x[6] = x[5];
+        x[5] = x[4];
+        x[4] = x[3] ^ x7;
+        x[3] = x[2] ^ x7;
+        x[2] = x[1];
+        x[1] = x[0] ^ x7;
+        x[0] = x7;
+    }
+
+    // 5.1.3 MixColumns() Transformation
+    //
+    // s'r = {02} (sr + sr+1) + sr+1 + sr+2 + sr+3
+    static void MixColumns(WordType* q) {
+        for (std::size_t h = 0; h < WORDS; h += 8) {
+            WordType r1[8], d[8];
+            for (std::size_t b = 0; b < 8; ++b) {
+                r1[b] = rotRow1(q[h + b]);
+                d[b] = q[h + b] ^ r1[b];
+            }
+
+            WordType x[8];
+            std::memcpy(x, d, sizeof(x));
+            xtime(x);
+
+            for (std::size_t b = 0; b < 8; ++b)
+                q[h + b] = x[b] ^ r1[b] ^ rotRow2(d[b]);
+        }
+    }
+
+    // 5.3.3 InvMixColumns() Transformation
+    //
+    // {0b}x^3 + {0d}x^2 + {09}x + {0e} = ({03}x^3 + x^2 + x + {02})({04}x^2 + {05})
+    // so s'r = sr + {04} (sr + sr+2) followed by MixColumns()
+    static void InvMixColumns(WordType* q) {
+        for (std::size_t h = 0; h < WORDS; h += 8) {
+            WordType x[8];
+            for (std::size_t b = 0; b < 8; ++b)
+                x[b] = q[h + b] ^ rotRow2(q[h + b]);
+
+            xtime(x);
+            xtime(x);
+
+            for (std::size_t b = 0; b < 8; ++b)
+                q[h + b] ^= x[b];
+        }
+
+        MixColumns(q);
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// bitsliced round keys
+//
+// Packed once by set() when the key is known, wiped by the destructor.
+//
+
+template <typename VAR, typename T, typename U, typename BITWISE>
+class AES_BitsliceKey
+{
+public:
+    typedef typename AES_Bitslice<VAR, T, U, BITWISE>::WordType WordType;
+
+    void set(const VAR*, const std::size_t) {
+    }
+
+    const WordType* data() const {
+        return nullptr;
+    }
+};
+
+template <>
+class AES_BitsliceKey<std::uint8_t,
+                      std::uint8_t,
+                      std::uint8_t,
+                      BitwiseINT<std::uint8_t>>
+{
+public:
+    typedef AES_Bitslice<std::uint8_t,
+                         std::uint8_t,
+                         std::uint8_t,
+                         BitwiseINT<std::uint8_t>> Bitslice;
+
+    typedef Bitslice::WordType WordType;
+
+    AES_BitsliceKey()
+        : m_rk()
+    {}
+
+    ~AES_BitsliceKey() {
+        wipe(m_rk);
+    }
+
+    // w is 16 * (Nr + 1) octets, at most AES-256 with 240
+    void set(const std::uint8_t* w, const std::size_t Nr) {
+        Bitslice::expandKey(w, Nr, m_rk);
+    }
+
+    const WordType* data() const {
+        return m_rk;
+    }
+
+private:
+    WordType m_rk[15 * Bitslice::WORDS];
+};
+
+} // namespace cryptl
+
+#endif
@@ -4,8 +4,11 @@
 #include <array>
 #include <cstdint>
 
+#include <cryptl/AES_Bitslice.hpp>
 #include <cryptl/AES_KeyExpansion.hpp>
+#include <cryptl/AES_NI.hpp>
 #include <cryptl/AES_SBox.hpp>
+#include <cryptl/AES_TTable.hpp>
 #include <cryptl/BitwiseINT.hpp>
 
 namespace cryptl {
@@ -33,8 +36,49 @@ public:
     typedef std::array<VAR, 16> BlockType;
     typedef AES_KeyExpansion<VAR, T, U, BITWISE> KeyExpansion;
 
+    // independent blocks per call in the parallel modes
+    static const std::size_t PARALLEL_BLOCKS = 8;
+    typedef std::array<VAR, 16 * PARALLEL_BLOCKS> BatchType;
+
+    // round keys derived from the key schedule for the backend in use
+    //
+    // Computed once by set() when the key is known, then only read, so one
+    // object may be shared by threads. Wiped on destruction.
+    class RoundKeys
+    {
+    public:
+        RoundKeys() = default;
+
+        template <std::size_t WSZ>
+        explicit RoundKeys(const std::array<VAR, WSZ>& w) {
+            set(w);
+        }
+
+        template <std::size_t WSZ>
+        void set(const std::array<VAR, WSZ>& w) {
+            const auto Nr = w.size() / 16 - 1;
+
+            if (AES_NI<VAR, T, U, BITWISE>::enabled()) return;
+
+            if (AES_Bitslice<VAR, T, U, BITWISE>::enabled())
+                m_bitslice.set(w.data(), Nr);
+        }
+
+        // bit planes for the bitsliced path
+        const AES_BitsliceKey<VAR, T, U, BITWISE>& bitslice() const {
+            return m_bitslice;
+        }
+
+    private:
+        AES_BitsliceKey<VAR, T, U, BITWISE> m_bitslice;
+    };
+
     AES_Cipher() = default;
 
+    // The round keys rk must be set from the same schedule w. Without them,
+    // they are derived again for every call of n blocks. A single block
+    // needs only w.
+
     // AES-128
     void operator() (const std::array<VAR, 16>& in,
                      std::array<VAR, 16>& out,
@@ -42,6 +86,13 @@ public:
         encrypt(in, out, w);
     }
 
+    void operator() (const std::array<VAR, 16>& in,
+                     std::array<VAR, 16>& out,
+                     const std::array<VAR, 176>& w,
+                     const RoundKeys&) const {
+        encrypt(in, out, w);
+    }
+
     // AES-192
     void operator() (const std::array<VAR, 16>& in,
                      std::array<VAR, 16>& out,
@@ -49,6 +100,13 @@ public:
         encrypt(in, out, w);
     }
 
+    void operator() (const std::array<VAR, 16>& in,
+                     std::array<VAR, 16>& out,
+                     const std::array<VAR, 208>& w,
+                     const RoundKeys&) const {
+        encrypt(in, out, w);
+    }
+
     // AES-256
     void operator() (const std::array<VAR, 16>& in,
                      std::array<VAR, 16>& out,
@@ -56,6 +114,63 @@ public:
         encrypt(in, out, w);
     }
 
+    void operator() (const std::array<VAR, 16>& in,
+                     std::array<VAR, 16>& out,
+                     const std::array<VAR, 240>& w,
+                     const RoundKeys&) const {
+        encrypt(in, out, w);
+    }
+
+    // n independent blocks of 16 octets, in may be the same as out
+
+    // AES-128
+    void operator() (const VAR* in,
+                     VAR* out,
+                     const std::size_t n,
+                     const std::array<VAR, 176>& w) const {
+        encrypt(in, out, n, w, RoundKeys(w));
+    }
+
+    void operator() (const VAR* in,
+                     VAR* out,
+                     const std::size_t n,
+                     const std::array<VAR, 176>& w,
+                     const RoundKeys& rk) const {
+        encrypt(in, out, n, w, rk);
+    }
+
+    // AES-192
+    void operator() (const VAR* in,
+                     VAR* out,
+                     const std::size_t n,
+                     const std::array<VAR, 208>& w) const {
+        encrypt(in, out, n, w, RoundKeys(w));
+    }
+
+    void operator() (const VAR* in,
+                     VAR* out,
+                     const std::size_t n,
+                     const std::array<VAR, 208>& w,
+                     const RoundKeys& rk) const {
+        encrypt(in, out, n, w, rk);
+    }
+
+    // AES-256
+    void operator() (const VAR* in,
+                     VAR* out,
+                     const std::size_t n,
+                     const std::array<VAR, 240>& w) const {
+        encrypt(in, out, n, w, RoundKeys(w));
+    }
+
+    void operator() (const VAR* in,
+                     VAR* out,
+                     const std::size_t n,
+                     const std::array<VAR, 240>& w,
+                     const RoundKeys& rk) const {
+        encrypt(in, out, n, w, rk);
+    }
+
 private:
     // AES-128 key schedule size 176 (Nr = 10)
     // AES-192 key schedule size 208 (Nr = 12)
@@ -67,6 +182,16 @@ private:
     {
         const auto Nr = w.size() / 16 - 1;
 
+        if (AES_NI<VAR, T, U, BITWISE>::enabled()) {
+            AES_NI<VAR, T, U, BITWISE>::encrypt(in.data(), out.data(), w.data(), Nr);
+            return;
+        }
+
+        if (AES_TTable<VAR, T, U, BITWISE>::enabled()) {
+            AES_TTable<VAR, T, U, BITWISE>::encrypt(in.data(), out.data(), w.data(), Nr);
+            return;
+        }
+
         auto state = in;
 
         AddRoundKey(state, w, 0);
@@ -85,6 +210,43 @@ private:
         out = state;
     }
 
+    template <std::size_t WSZ>
+    void encrypt(const VAR* in,
+                 VAR* out,
+                 const std::size_t n,
+                 const std::array<VAR, WSZ>& w,
+                 const RoundKeys& rk) const
+    {
+        typedef AES_Bitslice<VAR, T, U, BITWISE> Bitslice;
+
+        const auto Nr = w.size() / 16 - 1;
+
+        if (AES_NI<VAR, T, U, BITWISE>::enabled()) {
+            AES_NI<VAR, T, U, BITWISE>::encrypt(in, out, n, w.data(), Nr);
+            return;
+        }
+
+        // constant time without AES-NI
+        if (Bitslice::enabled()) {
+            for (std::size_t i = 0; i < n; i += Bitslice::BLOCKS) {
+                Bitslice::encrypt(in + 16*i,
+                                  out + 16*i,
+                                  n - i < Bitslice::BLOCKS ? n - i : Bitslice::BLOCKS,
+                                  rk.bitslice().data(),
+                                  Nr);
+            }
+
+            return;
+        }
+
+        std::array<VAR, 16> a, b;
+        for (std::size_t i = 0; i < n; ++i) {
+            for (std::size_t j = 0; j < 16; ++j) a[j] = in[16*i + j];
+            encrypt(a, b, w);
+            for (std::size_t j = 0; j < 16; ++j) out[16*i + j] = b[j];
+        }
+    }
+
     // 5.1.1 SubBytes() Transformation
     void SubBytes(std::array<VAR, 16>& state) const {
         for (auto& a : state)
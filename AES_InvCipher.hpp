@@ -4,8 +4,11 @@
 #include <array>
 #include <cstdint>
 
+#include <cryptl/AES_Bitslice.hpp>
 #include <cryptl/AES_InvSBox.hpp>
 #include <cryptl/AES_KeyExpansion.hpp>
+#include <cryptl/AES_NI.hpp>
+#include <cryptl/AES_TTable.hpp>
 #include <cryptl/BitwiseINT.hpp>
 
 namespace cryptl {
@@ -33,27 +36,148 @@ public:
     typedef std::array<VAR, 16> BlockType;
     typedef AES_KeyExpansion<VAR, T, U, BITWISE> KeyExpansion;
 
+    // independent blocks per call in the parallel modes
+    static const std::size_t PARALLEL_BLOCKS = 8;
+    typedef std::array<VAR, 16 * PARALLEL_BLOCKS> BatchType;
+
+    // round keys derived from the key schedule for the backend in use
+    //
+    // Computed once by set() when the key is known, then only read, so one
+    // object may be shared by threads. Wiped on destruction.
+    class RoundKeys
+    {
+    public:
+        RoundKeys() = default;
+
+        template <std::size_t WSZ>
+        explicit RoundKeys(const std::array<VAR, WSZ>& w) {
+            set(w);
+        }
+
+        template <std::size_t WSZ>
+        void set(const std::array<VAR, WSZ>& w) {
+            const auto Nr = w.size() / 16 - 1;
+
+            if (AES_NI<VAR, T, U, BITWISE>::enabled()) return;
+
+            if (AES_TTable<VAR, T, U, BITWISE>::enabled())
+                m_ttable.set(w.data(), Nr);
+
+            if (AES_Bitslice<VAR, T, U, BITWISE>::enabled())
+                m_bitslice.set(w.data(), Nr);
+        }
+
+        // equivalent inverse cipher round keys for the T-table path
+        const AES_TTableKey<VAR, T, U, BITWISE>& ttable() const {
+            return m_ttable;
+        }
+
+        // bit planes for the bitsliced path
+        const AES_BitsliceKey<VAR, T, U, BITWISE>& bitslice() const {
+            return m_bitslice;
+        }
+
+    private:
+        AES_TTableKey<VAR, T, U, BITWISE> m_ttable;
+        AES_BitsliceKey<VAR, T, U, BITWISE> m_bitslice;
+    };
+
     AES_InvCipher() = default;
 
+    // The round keys rk must be set from the same schedule w. Without them,
+    // a single block goes through AES-NI or the inverse cipher below, as
+    // deriving T-table keys for one block costs more than it saves.
+
     // AES-128
     void operator() (const std::array<VAR, 16>& in,
                      std::array<VAR, 16>& out,
                      const std::array<VAR, 176>& w) const {
-        decrypt(in, out, w);
+        decrypt(in, out, w, nullptr);
+    }
+
+    void operator() (const std::array<VAR, 16>& in,
+                     std::array<VAR, 16>& out,
+                     const std::array<VAR, 176>& w,
+                     const RoundKeys& rk) const {
+        decrypt(in, out, w, &rk.ttable());
     }
 
     // AES-192
     void operator() (const std::array<VAR, 16>& in,
                      std::array<VAR, 16>& out,
                      const std::array<VAR, 208>& w) const {
-        decrypt(in, out, w);
+        decrypt(in, out, w, nullptr);
+    }
+
+    void operator() (const std::array<VAR, 16>& in,
+                     std::array<VAR, 16>& out,
+                     const std::array<VAR, 208>& w,
+                     const RoundKeys& rk) const {
+        decrypt(in, out, w, &rk.ttable());
     }
 
     // AES-256
     void operator() (const std::array<VAR, 16>& in,
                      std::array<VAR, 16>& out,
                      const std::array<VAR, 240>& w) const {
-        decrypt(in, out, w);
+        decrypt(in, out, w, nullptr);
+    }
+
+    void operator() (const std::array<VAR, 16>& in,
+                     std::array<VAR, 16>& out,
+                     const std::array<VAR, 240>& w,
+                     const RoundKeys& rk) const {
+        decrypt(in, out, w, &rk.ttable());
+    }
+
+    // n independent blocks of 16 octets, in may be the same as out
+
+    // AES-128
+    void operator() (const VAR* in,
+                     VAR* out,
+                     const std::size_t n,
+                     const std::array<VAR, 176>& w) const {
+        decrypt(in, out, n, w, RoundKeys(w));
+    }
+
+    void operator() (const VAR* in,
+                     VAR* out,
+                     const std::size_t n,
+                     const std::array<VAR, 176>& w,
+                     const RoundKeys& rk) const {
+        decrypt(in, out, n, w, rk);
+    }
+
+    // AES-192
+    void operator() (const VAR* in,
+                     VAR* out,
+                     const std::size_t n,
+                     const std::array<VAR, 208>& w) const {
+        decrypt(in, out, n, w, RoundKeys(w));
+    }
+
+    void operator() (const VAR* in,
+                     VAR* out,
+                     const std::size_t n,
+                     const std::array<VAR, 208>& w,
+                     const RoundKeys& rk) const {
+        decrypt(in, out, n, w, rk);
+    }
+
+    // AES-256
+    void operator() (const VAR* in,
+                     VAR* out,
+                     const std::size_t n,
+                     const std::array<VAR, 240>& w) const {
+        decrypt(in, out, n, w, RoundKeys(w));
+    }
+
+    void operator() (const VAR* in,
+                     VAR* out,
+                     const std::size_t n,
+                     const std::array<VAR, 240>& w,
+                     const RoundKeys& rk) const {
+        decrypt(in, out, n, w, rk);
     }
 
 private:
@@ -63,10 +187,24 @@ private:
     template <std::size_t WSZ>
     void decrypt(const std::array<VAR, 16>& in,
                  std::array<VAR, 16>& out,
-                 const std::array<VAR, WSZ>& w) const // 16 * (Nr + 1) octets
+                 const std::array<VAR, WSZ>& w, // 16 * (Nr + 1) octets
+                 const AES_TTableKey<VAR, T, U, BITWISE>* dk) const
     {
         const auto Nr = w.size() / 16 - 1;
 
+        if (AES_NI<VAR, T, U, BITWISE>::enabled()) {
+            AES_NI<VAR, T, U, BITWISE>::decrypt(in.data(), out.data(), w.data(), Nr);
+            return;
+        }
+
+        if (nullptr != dk && AES_TTable<VAR, T, U, BITWISE>::enabled()) {
+            AES_TTable<VAR, T, U, BITWISE>::decrypt(in.data(),
+                                                    out.data(),
+                                                    dk->data(),
+                                                    Nr);
+            return;
+        }
+
         auto state = in;
 
         AddRoundKey(state, w, 16*Nr);
@@ -85,6 +223,43 @@ private:
         out = state;
     }
 
+    template <std::size_t WSZ>
+    void decrypt(const VAR* in,
+                 VAR* out,
+                 const std::size_t n,
+                 const std::array<VAR, WSZ>& w,
+                 const RoundKeys& rk) const
+    {
+        typedef AES_Bitslice<VAR, T, U, BITWISE> Bitslice;
+
+        const auto Nr = w.size() / 16 - 1;
+
+        if (AES_NI<VAR, T, U, BITWISE>::enabled()) {
+            AES_NI<VAR, T, U, BITWISE>::decrypt(in, out, n, w.data(), Nr);
+            return;
+        }
+
+        // constant time without AES-NI
+        if (Bitslice::enabled()) {
+            for (std::size_t i = 0; i < n; i += Bitslice::BLOCKS) {
+                Bitslice::decrypt(in + 16*i,
+                                  out + 16*i,
+                                  n - i < Bitslice::BLOCKS ? n - i : Bitslice::BLOCKS,
+                                  rk.bitslice().data(),
+                                  Nr);
+            }
+
+            return;
+        }
+
+        std::array<VAR, 16> a, b;
+        for (std::size_t i = 0; i < n; ++i) {
+            for (std::size_t j = 0; j < 16; ++j) a[j] = in[16*i + j];
+            decrypt(a, b, w, &rk.ttable());
+            for (std::size_t j = 0; j < 16; ++j) out[16*i + j] = b[j];
+        }
+    }
+
     // 5.3.1 InvShiftRows() Transformation
     void InvShiftRows(std::array<VAR, 16>& state) const {
         VAR tmp;
@@ -4,6 +4,7 @@
 #include <array>
 #include <cstdint>
 
+#include <cryptl/AES_NI.hpp>
 #include <cryptl/AES_SBox.hpp>
 
 namespace cryptl {
@@ -94,6 +95,11 @@ private:
             Nk = key.size() / 4,
             Nr = w.size() / 16 - 1;
 
+        if (AES_NI<VAR, T, U, BITWISE>::enabled()) {
+            AES_NI<VAR, T, U, BITWISE>::expand(key.data(), Nk, w.data());
+            return;
+        }
+
         for (std::size_t i = 0; i < Nk; ++i) {
             w[4*i] = key[4*i];
             w[4*i + 1] = key[4*i + 1];
@@ -0,0 +1,314 @@
+#ifndef _CRYPTL_AES_NI_HPP_
+#define _CRYPTL_AES_NI_HPP_
+
+#include <cstdint>
+
+#include <cryptl/BitwiseINT.hpp>
+#include <cryptl/CPU_Features.hpp>
+
+#ifdef CRYPTL_X86_64
+#include <immintrin.h>
+#endif
+
+namespace cryptl {
+
+////////////////////////////////////////////////////////////////////////////////
+// AES with the x86 AES instructions for unmanaged bytes
+//
+// The key schedule is the same 16 * (Nr + 1) octets as AES_KeyExpansion, each
+// round key is one 128-bit register loaded as is. Decryption is the equivalent
+// inverse cipher, aesimc on the round keys is independent of the state so it
+// overlaps with the aesdec chain.
+//
+
+template <typename VAR, typename T, typename U, typename BITWISE>
+class AES_NI
+{
+public:
+    static bool enabled() { return false; }
+
+    static void expand(const VAR*, const std::size_t, VAR*) {
+    }
+
+    static void encrypt(const VAR*, VAR*, const VAR*, const std::size_t) {
+    }
+
+    static void decrypt(const VAR*, VAR*, const VAR*, const std::size_t) {
+    }
+
+    static void encrypt(const VAR*,
+                        VAR*,
+                        const std::size_t,
+                        const VAR*,
+                        const std::size_t) {
+    }
+
+    static void decrypt(const VAR*,
+                        VAR*,
+                        const std::size_t,
+                        const VAR*,
+                        const std::size_t) {
+    }
+};
+
+template <>
+class AES_NI<std::uint8_t,
+             std::uint8_t,
+             std::uint8_t,
+             BitwiseINT<std::uint8_t>>
+{
+public:
+    static bool enabled() {
+        return CPU_Features::hasAES();
+    }
+
+#ifdef CRYPTL_X86_64
+    // FIPS PUB 197 section 5.2, Nk words at a time
+    __attribute__((target("aes,sse4.1")))
+    static void expand(const std::uint8_t* key, // 4 * Nk octets
+                       const std::size_t Nk,
+                       std::uint8_t* w)         // 16 * (Nk + 7) octets
+    {
+        switch (Nk) {
+        case (4) : expand128(key, w); break;
+        case (6) : expand192(key, w); break;
+        case (8) : expand256(key, w); break;
+        }
+    }
+
+    __attribute__((target("aes,sse4.1")))
+    static void encrypt(const std::uint8_t* in,
+                        std::uint8_t* out,
+                        const std::uint8_t* w,
+                        const std::size_t Nr)
+    {
+        __m128i state = _mm_xor_si128(load(in), load(w));
+
+        for (std::size_t round = 1; round < Nr; ++round)
+            state = _mm_aesenc_si128(state, load(w + 16*round));
+
+        state = _mm_aesenclast_si128(state, load(w + 16*Nr));
+
+        store(out, state);
+    }
+
+    // w is the encryption key schedule
+    __attribute__((target("aes,sse4.1")))
+    static void decrypt(const std::uint8_t* in,
+                        std::uint8_t* out,
+                        const std::uint8_t* w,
+                        const std::size_t Nr)
+    {
+        __m128i state = _mm_xor_si128(load(in), load(w + 16*Nr));
+
+        for (std::size_t round = Nr - 1; round > 0; --round)
+            state = _mm_aesdec_si128(state, _mm_aesimc_si128(load(w + 16*round)));
+
+        state = _mm_aesdeclast_si128(state, load(w));
+
+        store(out, state);
+    }
+
+    // n independent blocks, eight at a time so the aesenc latency is hidden
+    __attribute__((target("aes,sse4.1")))
+    static void encrypt(const std::uint8_t* in,
+                        std::uint8_t* out,
+                        const std::size_t n,
+                        const std::uint8_t* w,
+                        const std::size_t Nr)
+    {
+        std::size_t i = 0;
+
+        for (; i + 8 <= n; i += 8) {
+            __m128i state[8];
+
+            for (std::size_t j = 0; j < 8; ++j)
+                state[j] = _mm_xor_si128(load(in + 16*(i + j)), load(w));
+
+            for (std::size_t round = 1; round < Nr; ++round) {
+                const __m128i k = load(w + 16*round);
+                for (std::size_t j = 0; j < 8; ++j)
+                    state[j] = _mm_aesenc_si128(state[j], k);
+            }
+
+            const __m128i k = load(w + 16*Nr);
+            for (std::size_t j = 0; j < 8; ++j)
+                store(out + 16*(i + j), _mm_aesenclast_si128(state[j], k));
+        }
+
+        for (; i < n; ++i)
+            encrypt(in + 16*i, out + 16*i, w, Nr);
+    }
+
+    __attribute__((target("aes,sse4.1")))
+    static void decrypt(const std::uint8_t* in,
+                        std::uint8_t* out,
+                        const std::size_t n,
+                        const std::uint8_t* w,
+                        const std::size_t Nr)
+    {
+        // equivalent inverse cipher round keys, at most AES-256
+        __m128i dk[15];
+        dk[0] = load(w + 16*Nr);
+        for (std::size_t round = 1; round < Nr; ++round)
+            dk[round] = _mm_aesimc_si128(load(w + 16*(Nr - round)));
+        dk[Nr] = load(w);
+
+        std::size_t i = 0;
+
+        for (; i + 8 <= n; i += 8) {
+            __m128i state[8];
+
+            for (std::size_t j = 0; j < 8; ++j)
+                state[j] = _mm_xor_si128(load(in + 16*(i + j)), dk[0]);
+
+            for (std::size_t round = 1; round < Nr; ++round) {
+                for (std::size_t j = 0; j < 8; ++j)
+                    state[j] = _mm_aesdec_si128(state[j], dk[round]);
+            }
+
+            for (std::size_t j = 0; j < 8; ++j)
+                store(out + 16*(i + j), _mm_aesdeclast_si128(state[j], dk[Nr]));
+        }
+
+        for (; i < n; ++i)
+            decrypt(in + 16*i, out + 16*i, w, Nr);
+    }
+
+private:
+    __attribute__((target("sse2")))
+    static __m128i load(const std::uint8_t* p) {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    }
+
+    __attribute__((target("sse2")))
+    static void store(std::uint8_t* p, const __m128i a) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(p), a);
+    }
+
+    // low eight bytes
+    __attribute__((target("sse2")))
+    static void storeLow(std::uint8_t* p, const __m128i a) {
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(p), a);
+    }
+
+    // each word XOR all words before it
+    __attribute__((target("sse2")))
+    static __m128i prefixXOR(__m128i a) {
+        a = _mm_xor_si128(a, _mm_slli_si128(a, 4));
+        return _mm_xor_si128(a, _mm_slli_si128(a, 8));
+    }
+
+    // SubWord(RotWord()) of word n XOR rcon, in all four words
+    //
+    // aeskeygenassist is microcoded on many cores. With the same word in every
+    // column, ShiftRows does nothing so aesenclast is SubBytes and XOR.
+    __attribute__((target("aes,sse4.1")))
+    static __m128i subRotWord(const __m128i a, const int n, const std::uint8_t rcon) {
+        const char i = 4 * n;
+        const __m128i rot = _mm_setr_epi8(i+1, i+2, i+3, i, i+1, i+2, i+3, i,
+                                          i+1, i+2, i+3, i, i+1, i+2, i+3, i);
+
+        return _mm_aesenclast_si128(_mm_shuffle_epi8(a, rot), _mm_set1_epi32(rcon));
+    }
+
+    // SubWord() of word 3 in all four words
+    __attribute__((target("aes,sse4.1")))
+    static __m128i subWord(const __m128i a) {
+        return _mm_aesenclast_si128(_mm_shuffle_epi32(a, 0xff), _mm_setzero_si128());
+    }
+
+    static std::uint8_t xtime(const std::uint8_t rcon) {
+        return (rcon << 1) ^ (0x80 & rcon ? 0x1b : 0);
+    }
+
+    __attribute__((target("aes,sse4.1")))
+    static void expand128(const std::uint8_t* key, std::uint8_t* w) {
+        __m128i a = load(key);
+        store(w, a);
+
+        std::uint8_t rcon = 0x01;
+        for (std::size_t i = 1; i <= 10; ++i, rcon = xtime(rcon)) {
+            a = _mm_xor_si128(prefixXOR(a), subRotWord(a, 3, rcon));
+            store(w + 16*i, a);
+        }
+    }
+
+    // six words per round, four in a and two in the low half of b
+    __attribute__((target("aes,sse4.1")))
+    static void expand192(const std::uint8_t* key, std::uint8_t* w) {
+        __m128i a = load(key),
+                b = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(key + 16));
+
+        store(w, a);
+        storeLow(w + 16, b);
+
+        std::uint8_t rcon = 0x01;
+        for (std::size_t i = 1; i <= 8; ++i, rcon = xtime(rcon)) {
+            a = _mm_xor_si128(prefixXOR(a), subRotWord(b, 1, rcon));
+            store(w + 24*i, a);
+
+            // last round only needs four of the six words
+            if (8 == i) break;
+
+            b = _mm_xor_si128(_mm_xor_si128(b, _mm_slli_si128(b, 4)),
+                              _mm_shuffle_epi32(a, 0xff));
+            storeLow(w + 24*i + 16, b);
+        }
+    }
+
+    // eight words per round in a and b
+    __attribute__((target("aes,sse4.1")))
+    static void expand256(const std::uint8_t* key, std::uint8_t* w) {
+        __m128i a = load(key), b = load(key + 16);
+
+        store(w, a);
+        store(w + 16, b);
+
+        std::uint8_t rcon = 0x01;
+        for (std::size_t i = 1; i <= 7; ++i, rcon = xtime(rcon)) {
+            a = _mm_xor_si128(prefixXOR(a), subRotWord(b, 3, rcon));
+            store(w + 32*i, a);
+
+            // last round only needs the first four words
+            if (7 == i) break;
+
+            b = _mm_xor_si128(prefixXOR(b), subWord(a));
+            store(w + 32*i + 16, b);
+        }
+    }
+#else
+    static void expand(const std::uint8_t*, const std::size_t, std::uint8_t*) {
+    }
+
+    static void encrypt(const std::uint8_t*,
+                        std::uint8_t*,
+                        const std::uint8_t*,
+                        const std::size_t) {
+    }
+
+    static void decrypt(const std::uint8_t*,
+                        std::uint8_t*,
+                        const std::uint8_t*,
+                        const std::size_t) {
+    }
+
+    static void encrypt(const std::uint8_t*,
+                        std::uint8_t*,
+                        const std::size_t,
+                        const std::uint8_t*,
+                        const std::size_t) {
+    }
+
+    static void decrypt(const std::uint8_t*,
+                        std::uint8_t*,
+                        const std::size_t,
+                        const std::uint8_t*,
+                        const std::size_t) {
+    }
+#endif
+};
+
+} // namespace cryptl
+
+#endif
@@ -0,0 +1,307 @@
+#ifndef _CRYPTL_AES_TTABLE_HPP_
+#define _CRYPTL_AES_TTABLE_HPP_
+
+#include <array>
+#include <cstdint>
+
+#include <cryptl/AES_InvSBox.hpp>
+#include <cryptl/AES_SBox.hpp>
+#include <cryptl/BitwiseINT.hpp>
+#include <cryptl/Wipe.hpp>
+
+namespace cryptl {
+
+////////////////////////////////////////////////////////////////////////////////
+// AES lookup tables for 32-bit columns
+//
+// Te0[x] is the column (2 S[x], S[x], S[x], 3 S[x]) as a big-endian word,
+// Td0[x] is (14 Si[x], 9 Si[x], 13 Si[x], 11 Si[x]). Te1..Te3 and Td1..Td3
+// are the same rotated right by one, two and three bytes. Computed once from
+// the S-boxes on first use.
+//
+// note: lookups are indexed by key dependent data, so cache timing is not
+// constant
+//
+
+class AES_TTables
+{
+public:
+    typedef std::array<std::uint32_t, 256> TableType;
+
+    static const AES_TTables& get() {
+        static const AES_TTables a;
+        return a;
+    }
+
+    std::array<TableType, 4> Te, Td;
+
+    // S-box and inverse S-box for the last round
+    std::array<std::uint8_t, 256> S, Si;
+
+private:
+    AES_TTables() {
+        typedef BitwiseINT<std::uint8_t> B;
+
+        const AES_SBox<std::uint8_t, std::uint8_t, B> sbox;
+        const AES_InvSBox<std::uint8_t, std::uint8_t, B> inv_sbox;
+
+        // irreducible polynomial for AES
+        const std::uint8_t modpoly = 0x1b;
+
+        for (std::size_t x = 0; x < 256; ++x) {
+            const std::uint8_t s = sbox(x), si = inv_sbox(x);
+
+            S[x] = s;
+            Si[x] = si;
+
+            Te[0][x] = column(B::multiply(s, 2, modpoly),
+                              s,
+                              s,
+                              B::multiply(s, 3, modpoly));
+
+            Td[0][x] = column(B::multiply(si, 14, modpoly),
+                              B::multiply(si, 9, modpoly),
+                              B::multiply(si, 13, modpoly),
+                              B::multiply(si, 11, modpoly));
+
+            for (std::size_t i = 1; i < 4; ++i) {
+                Te[i][x] = ROTR(Te[0][x], 8 * i);
+                Td[i][x] = ROTR(Td[0][x], 8 * i);
+            }
+        }
+    }
+
+    static std::uint32_t column(const std::uint32_t a0,
+                                const std::uint32_t a1,
+                                const std::uint32_t a2,
+                                const std::uint32_t a3) {
+        return (a0 << 24) | (a1 << 16) | (a2 << 8) | a3;
+    }
+
+    static std::uint32_t ROTR(const std::uint32_t x, const std::size_t n) {
+        return (x >> n) | (x << (32 - n));
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// AES with T-tables for unmanaged bytes
+//
+// One round of a column is four lookups and four XORs, the tables combine
+// SubBytes, ShiftRows (which state bytes index them) and MixColumns.
+// Decryption is the equivalent inverse cipher (FIPS PUB 197 section 5.3.5)
+// with InvMixColumns applied to the round keys in advance.
+//
+
+template <typename VAR, typename T, typename U, typename BITWISE>
+class AES_TTable
+{
+public:
+    static bool enabled() { return false; }
+
+    static void encrypt(const VAR*, VAR*, const VAR*, const std::size_t) {
+    }
+
+    static void decrypt(const VAR*, VAR*, const std::uint32_t*, const std::size_t) {
+    }
+};
+
+template <>
+class AES_TTable<std::uint8_t,
+                 std::uint8_t,
+                 std::uint8_t,
+                 BitwiseINT<std::uint8_t>>
+{
+public:
+    static bool enabled() { return true; }
+
+    // w is the key schedule from AES_KeyExpansion, 16 * (Nr + 1) octets
+    static void encrypt(const std::uint8_t* in,
+                        std::uint8_t* out,
+                        const std::uint8_t* w,
+                        const std::size_t Nr)
+    {
+        const auto& tab = AES_TTables::get();
+        const auto &Te0 = tab.Te[0], &Te1 = tab.Te[1],
+                   &Te2 = tab.Te[2], &Te3 = tab.Te[3];
+
+        std::uint32_t
+            s0 = load(in) ^ load(w),
+            s1 = load(in + 4) ^ load(w + 4),
+            s2 = load(in + 8) ^ load(w + 8),
+            s3 = load(in + 12) ^ load(w + 12);
+
+        for (std::size_t round = 1; round < Nr; ++round) {
+            const std::uint8_t* rk = w + 16 * round;
+
+            const std::uint32_t
+                t0 = Te0[s0 >> 24] ^ Te1[(s1 >> 16) & 0xff] ^
+                     Te2[(s2 >> 8) & 0xff] ^ Te3[s3 & 0xff] ^ load(rk),
+                t1 = Te0[s1 >> 24] ^ Te1[(s2 >> 16) & 0xff] ^
+                     Te2[(s3 >> 8) & 0xff] ^ Te3[s0 & 0xff] ^ load(rk + 4),
+                t2 = Te0[s2 >> 24] ^ Te1[(s3 >> 16) & 0xff] ^
+                     Te2[(s0 >> 8) & 0xff] ^ Te3[s1 & 0xff] ^ load(rk + 8),
+                t3 = Te0[s3 >> 24] ^ Te1[(s0 >> 16) & 0xff] ^
+                     Te2[(s1 >> 8) & 0xff] ^ Te3[s2 & 0xff] ^ load(rk + 12);
+
+            s0 = t0;
+            s1 = t1;
+            s2 = t2;
+            s3 = t3;
+        }
+
+        // no MixColumns in the last round
+        const std::uint8_t* rk = w + 16 * Nr;
+        store(out, lastRound(tab.S, s0, s1, s2, s3) ^ load(rk));
+        store(out + 4, lastRound(tab.S, s1, s2, s3, s0) ^ load(rk + 4));
+        store(out + 8, lastRound(tab.S, s2, s3, s0, s1) ^ load(rk + 8));
+        store(out + 12, lastRound(tab.S, s3, s0, s1, s2) ^ load(rk + 12));
+    }
+
+    // decryption round keys from the AES_KeyExpansion schedule w, in the
+    // order used: 4 * (Nr + 1) words
+    static void decryptKey(const std::uint8_t* w,
+                           const std::size_t Nr,
+                           std::uint32_t* dk)
+    {
+        const auto& tab = AES_TTables::get();
+
+        for (std::size_t round = 0; round <= Nr; ++round) {
+            const std::uint8_t* rk = w + 16 * (Nr - round);
+
+            for (std::size_t i = 0; i < 4; ++i) {
+                const std::uint32_t k = load(rk + 4 * i);
+
+                // InvMixColumns, the S-box cancels the inverse S-box in Td
+                dk[4 * round + i] = (0 == round || Nr == round)
+                    ? k
+                    : tab.Td[0][tab.S[k >> 24]] ^
+                      tab.Td[1][tab.S[(k >> 16) & 0xff]] ^
+                      tab.Td[2][tab.S[(k >> 8) & 0xff]] ^
+                      tab.Td[3][tab.S[k & 0xff]];
+            }
+        }
+    }
+
+    // dk from decryptKey()
+    static void decrypt(const std::uint8_t* in,
+                        std::uint8_t* out,
+                        const std::uint32_t* dk,
+                        const std::size_t Nr)
+    {
+        const auto& tab = AES_TTables::get();
+        const auto &Td0 = tab.Td[0], &Td1 = tab.Td[1],
+                   &Td2 = tab.Td[2], &Td3 = tab.Td[3];
+
+        std::uint32_t
+            s0 = load(in) ^ dk[0],
+            s1 = load(in + 4) ^ dk[1],
+            s2 = load(in + 8) ^ dk[2],
+            s3 = load(in + 12) ^ dk[3];
+
+        for (std::size_t round = 1; round < Nr; ++round) {
+            const std::uint32_t* rk = dk + 4 * round;
+
+            const std::uint32_t
+                t0 = Td0[s0 >> 24] ^ Td1[(s3 >> 16) & 0xff] ^
+                     Td2[(s2 >> 8) & 0xff] ^ Td3[s1 & 0xff] ^ rk[0],
+                t1 = Td0[s1 >> 24] ^ Td1[(s0 >> 16) & 0xff] ^
+                     Td2[(s3 >> 8) & 0xff] ^ Td3[s2 & 0xff] ^ rk[1],
+                t2 = Td0[s2 >> 24] ^ Td1[(s1 >> 16) & 0xff] ^
+                     Td2[(s0 >> 8) & 0xff] ^ Td3[s3 & 0xff] ^ rk[2],
+                t3 = Td0[s3 >> 24] ^ Td1[(s2 >> 16) & 0xff] ^
+                     Td2[(s1 >> 8) & 0xff] ^ Td3[s0 & 0xff] ^ rk[3];
+
+            s0 = t0;
+            s1 = t1;
+            s2 = t2;
+            s3 = t3;
+        }
+
+        // no InvMixColumns in the last round
+        const std::uint32_t* rk = dk + 4 * Nr;
+        store(out, lastRound(tab.Si, s0, s3, s2, s1) ^ rk[0]);
+        store(out + 4, lastRound(tab.Si, s1, s0, s3, s2) ^ rk[1]);
+        store(out + 8, lastRound(tab.Si, s2, s1, s0, s3) ^ rk[2]);
+        store(out + 12, lastRound(tab.Si, s3, s2, s1, s0) ^ rk[3]);
+    }
+
+private:
+    static std::uint32_t load(const std::uint8_t* p) {
+        return (std::uint32_t(p[0]) << 24) | (std::uint32_t(p[1]) << 16) |
+               (std::uint32_t(p[2]) << 8) | std::uint32_t(p[3]);
+    }
+
+    static void store(std::uint8_t* p, const std::uint32_t a) {
+        p[0] = a >> 24;
+        p[1] = a >> 16;
+        p[2] = a >> 8;
+        p[3] = a;
+    }
+
+    // substitute one byte from each of four columns (shifted rows)
+    static std::uint32_t lastRound(const std::array<std::uint8_t, 256>& box,
+                                   const std::uint32_t a0,
+                                   const std::uint32_t a1,
+                                   const std::uint32_t a2,
+                                   const std::uint32_t a3) {
+        return (std::uint32_t(box[a0 >> 24]) << 24) |
+               (std::uint32_t(box[(a1 >> 16) & 0xff]) << 16) |
+               (std::uint32_t(box[(a2 >> 8) & 0xff]) << 8) |
+               std::uint32_t(box[a3 & 0xff]);
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// decryption round keys for the T-table inverse cipher
+//
+// The equivalent inverse cipher needs the encryption key schedule
+// transformed. set() does it once when the key is known, the destructor
+// wipes the result.
+//
+
+template <typename VAR, typename T, typename U, typename BITWISE>
+class AES_TTableKey
+{
+public:
+    void set(const VAR*, const std::size_t) {
+    }
+
+    const std::uint32_t* data() const {
+        return nullptr;
+    }
+};
+
+template <>
+class AES_TTableKey<std::uint8_t,
+                    std::uint8_t,
+                    std::uint8_t,
+                    BitwiseINT<std::uint8_t>>
+{
+public:
+    AES_TTableKey()
+        : m_dk()
+    {}
+
+    ~AES_TTableKey() {
+        wipe(m_dk);
+    }
+
+    // w is 16 * (Nr + 1) octets, at most AES-256 with 240
+    void set(const std::uint8_t* w, const std::size_t Nr) {
+        AES_TTable<std::uint8_t,
+                   std::uint8_t,
+                   std::uint8_t,
+                   BitwiseINT<std::uint8_t>>::decryptKey(w, Nr, m_dk.data());
+    }
+
+    const std::uint32_t* data() const {
+        return m_dk.data();
+    }
+
+private:
+    std::array<std::uint32_t, 60> m_dk;
+};
+
+} // namespace cryptl
+
+#endif
@@ -0,0 +1,203 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "cryptl/AES.hpp"
+#include "cryptl/CipherModes.hpp"
+#include "cryptl/Digest.hpp"
+#include "cryptl/PBKDF2.hpp"
+#include "cryptl/SHA_1.hpp"
+#include "cryptl/SHA_256.hpp"
+#include "cryptl/SHA_512.hpp"
+
+using namespace cryptl;
+using namespace std;
+
+void printUsage(const char* exeName) {
+    cerr << "usage: " << exeName << " -b construct|pbkdf2|cipher" << endl
+         << "  construct  make a hasher, then digest one 64-byte record" << endl
+         << "  pbkdf2     PBKDF2 iterations, one password and a batch" << endl
+         << "  cipher     ECB messages with a context, and setting the key each time" << endl;
+
+    exit(EXIT_FAILURE);
+}
+
+// results feed into this so the work is not optimized away
+volatile uint64_t sink = 0;
+
+// nanoseconds per call of func(), repeated for at least a quarter second
+double nanosPerCall(const function<void ()>& func)
+{
+    typedef chrono::steady_clock Clock;
+
+    // warm up caches and the branch predictor
+    for (size_t i = 0; i < 1000; ++i) func();
+
+    size_t calls = 0;
+    const auto start = Clock::now();
+    auto elapsed = Clock::duration::zero();
+
+    while (elapsed < chrono::milliseconds(250)) {
+        for (size_t i = 0; i < 1000; ++i) func();
+        calls += 1000;
+        elapsed = Clock::now() - start;
+    }
+
+    return chrono::duration<double, nano>(elapsed).count() / calls;
+}
+
+void printResult(const string& name, const string& what, const double ns)
+{
+    cout << left << setw(12) << name
+         << setw(28) << what
+         << right << fixed << setprecision(1) << setw(10) << ns << " ns"
+         << endl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// hasher construction (shared constant tables)
+//
+
+template <typename T>
+void benchConstruct(const string& name)
+{
+    printResult(
+        name,
+        "new and delete",
+        nanosPerCall(
+            [] () {
+                unique_ptr<T> p(new T);
+                sink += reinterpret_cast<uintptr_t>(p.get());
+            }));
+
+    const vector<uint8_t> record(64, 0x5a);
+
+    printResult(
+        name,
+        "digest of 64 bytes",
+        nanosPerCall(
+            [&record] () {
+                sink += digest(T(), record.data(), record.size())[0];
+            }));
+}
+
+void benchConstruct()
+{
+    benchConstruct<SHA1>("SHA1");
+    benchConstruct<SHA256>("SHA256");
+    benchConstruct<SHA512>("SHA512");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// PBKDF2 throughput (one password at a time or a batch in SIMD lanes)
+//
+
+template <typename T, typename LANES>
+void benchPBKDF2(const string& name, const size_t batch)
+{
+    const size_t c = 1000;
+    const PBKDF2<T, LANES> kdf;
+
+    vector<vector<uint8_t>> P(batch, vector<uint8_t>(8, 0x5a)), S(batch, vector<uint8_t>(16, 0xa5));
+    for (size_t k = 0; k < batch; ++k) P[k][0] = k;
+
+    const double ns = nanosPerCall(
+        [&kdf, &P, &S] () {
+            sink += kdf.derive(P, S, c, HMAC<T>::DIGEST_BYTES)[0][0];
+        });
+
+    // iterations for all passwords, per second
+    const double rate = 1e9 * c * batch / ns;
+
+    cout << left << setw(12) << name
+         << setw(28) << (to_string(batch) + " password" + (1 == batch ? "" : "s"))
+         << right << fixed << setprecision(0) << setw(10) << rate << " iterations/s"
+         << endl;
+}
+
+void benchPBKDF2()
+{
+    benchPBKDF2<SHA1, SHA_NoLanes>("SHA1", 1);
+    benchPBKDF2<SHA256, SHA_256_Lanes>("SHA256", 1);
+    benchPBKDF2<SHA256, SHA_256_Lanes>("SHA256", 16);
+    benchPBKDF2<SHA512, SHA_512_Lanes>("SHA512", 1);
+    benchPBKDF2<SHA512, SHA_512_Lanes>("SHA512", 8);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// block cipher context reuse (key schedule and round keys computed once)
+//
+
+template <typename T>
+void benchCipher(const string& name, const size_t bytes)
+{
+    typename T::KeyType key;
+    for (size_t i = 0; i < key.size(); ++i) key[i] = i;
+
+    const CipherContext<T> ctx(key);
+
+    vector<uint8_t> msg(bytes, 0x5a);
+
+    printResult(
+        name,
+        "context, " + to_string(bytes) + " bytes",
+        nanosPerCall(
+            [&ctx, &msg] () {
+                ECB(ctx, msg.data(), msg.data(), msg.size());
+                sink += msg[0];
+            }));
+
+    printResult(
+        name,
+        "set key, " + to_string(bytes) + " bytes",
+        nanosPerCall(
+            [&key, &msg] () {
+                const CipherContext<T> ctx(key);
+                ECB(ctx, msg.data(), msg.data(), msg.size());
+                sink += msg[0];
+            }));
+}
+
+void benchCipher()
+{
+    for (const size_t bytes : { 64, 1024 }) {
+        benchCipher<AES128>("AES128", bytes);
+        benchCipher<UNAES128>("UNAES128", bytes);
+        benchCipher<AES256>("AES256", bytes);
+        benchCipher<UNAES256>("UNAES256", bytes);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    string bench;
+    int opt;
+    while (-1 != (opt = getopt(argc, argv, "b:"))) {
+        switch (opt) {
+        case ('b') :
+            bench = optarg;
+            break;
+
+        default :
+            printUsage(argv[0]);
+        }
+    }
+
+    if ("construct" == bench)
+        benchConstruct();
+    else if ("pbkdf2" == bench)
+        benchPBKDF2();
+    else if ("cipher" == bench)
+        benchCipher();
+    else
+        printUsage(argv[0]);
+
+    return EXIT_SUCCESS;
+}
@@ -46,6 +46,44 @@ bool bless(std::uint64_t& a, T& is) {
     return bless_internal(a, is);
 }
 
+// 32-bit big-endian values from memory
+inline void blessBigEndian(std::uint32_t& a, const std::uint8_t* p) {
+    a = (static_cast<std::uint32_t>(p[0]) << 3 * CHAR_BIT) |
+        (static_cast<std::uint32_t>(p[1]) << 2 * CHAR_BIT) |
+        (static_cast<std::uint32_t>(p[2]) << CHAR_BIT) |
+        static_cast<std::uint32_t>(p[3]);
+}
+
+// 64-bit big-endian values from memory
+inline void blessBigEndian(std::uint64_t& a, const std::uint8_t* p) {
+    std::uint32_t hi, lo;
+    blessBigEndian(hi, p);
+    blessBigEndian(lo, p + 4);
+    a = (static_cast<std::uint64_t>(hi) << 4 * CHAR_BIT) | lo;
+}
+
+// 32-bit values to big-endian memory
+inline void storeBigEndian(std::uint8_t* p, const std::uint32_t a) {
+    p[0] = a >> 3 * CHAR_BIT;
+    p[1] = a >> 2 * CHAR_BIT;
+    p[2] = a >> CHAR_BIT;
+    p[3] = a;
+}
+
+// 64-bit values to big-endian memory
+inline void storeBigEndian(std::uint8_t* p, const std::uint64_t a) {
+    storeBigEndian(p, static_cast<std::uint32_t>(a >> 4 * CHAR_BIT));
+    storeBigEndian(p + 4, static_cast<std::uint32_t>(a));
+}
+
+// array (e.g. message digest) to big-endian memory
+template <typename T, std::size_t N>
+void storeBigEndian(std::uint8_t* p, const std::array<T, N>& a) {
+    for (std::size_t i = 0; i < N; ++i) {
+        storeBigEndian(p + i * sizeof(T), a[i]);
+    }
+}
+
 // array from input stream
 template <typename T, std::size_t N>
 bool bless(std::array<T, N>& a,
@@ -0,0 +1,224 @@
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "cryptl/AES.hpp"
+#include "cryptl/ASCII_Hex.hpp"
+#include "cryptl/CipherModes.hpp"
+
+using namespace cryptl;
+using namespace std;
+
+void printUsage(const char* exeName) {
+    const string
+        B = " -b 128|192|256",
+        M = " -m ECB|CBC|OFB|CFB",
+        D = " [-d]",
+        K = " -k key_in_hex",
+        I = " [-i IV_in_hex]",
+        T = " -t text_in_hex";
+
+    cerr << exeName << B << M << D << K << I << T << endl;
+
+    exit(EXIT_FAILURE);
+}
+
+// text through the mode with a context
+template <typename T>
+vector<uint8_t> cryptText(const CipherContext<T>& ctx,
+                          const string& blockMode,
+                          const typename T::BlockType& IV,
+                          const vector<uint8_t>& text)
+{
+    if ("ECB" == blockMode)
+        return ECB(ctx, text);
+    else if ("CBC" == blockMode)
+        return CBC(ctx, IV, text);
+    else if ("OFB" == blockMode)
+        return OFB(ctx, IV, text);
+    else
+        return CFB(ctx, IV, text);
+}
+
+// n octets at in through the mode to out, which may be the same as in
+template <typename T>
+void cryptBuffer(const CipherContext<T>& ctx,
+                 const string& blockMode,
+                 const typename T::BlockType& IV,
+                 const uint8_t* in,
+                 uint8_t* out,
+                 const size_t n)
+{
+    if ("ECB" == blockMode)
+        ECB(ctx, in, out, n);
+    else if ("CBC" == blockMode)
+        CBC(ctx, IV, in, out, n);
+    else if ("OFB" == blockMode)
+        OFB(ctx, IV, in, out, n);
+    else
+        CFB(ctx, IV, in, out, n);
+}
+
+// text through the mode with a key expanded for the call
+template <typename T>
+vector<uint8_t> cryptText(const typename T::KeyType& key,
+                          const string& blockMode,
+                          const typename T::BlockType& IV,
+                          const vector<uint8_t>& text)
+{
+    if ("ECB" == blockMode)
+        return ECB(T(), key, text);
+    else if ("CBC" == blockMode)
+        return CBC(T(), key, IV, text);
+    else if ("OFB" == blockMode)
+        return OFB(T(), key, IV, text);
+    else
+        return CFB(T(), key, IV, text);
+}
+
+// A key expanded for the call, a context made with the key, and a context
+// used with another key before this one must all agree. The contexts are
+// used twice. The text written to a caller's buffer and in place must be
+// the same too.
+template <typename T>
+void runCipher(const string& blockMode,
+               const string& key,
+               const string& IV,
+               const vector<uint8_t>& text)
+{
+    typename T::KeyType bkey;
+    if (!asciiHexToArray(key, bkey)) {
+        cout << "CIPHER: key length" << endl;
+        return;
+    }
+
+    typename T::BlockType bIV = {};
+    if (!IV.empty() && !asciiHexToArray(IV, bIV)) {
+        cout << "CIPHER: IV length" << endl;
+        return;
+    }
+
+    const auto out = cryptText<T>(bkey, blockMode, bIV, text);
+
+    const CipherContext<T> a(bkey);
+
+    auto otherKey = bkey;
+    for (auto& k : otherKey) k ^= 0xff;
+
+    CipherContext<T> b(otherKey);
+    if (!text.empty() && cryptText(b, blockMode, bIV, text) == out) {
+        cout << "CIPHER: other key same text" << endl;
+        return;
+    }
+
+    b.setKey(bkey);
+
+    for (size_t pass = 0; pass < 2; ++pass) {
+        if (cryptText(a, blockMode, bIV, text) != out ||
+            cryptText(b, blockMode, bIV, text) != out) {
+            cout << "CIPHER: context mismatch" << endl;
+            return;
+        }
+    }
+
+    vector<uint8_t> buf(text.size());
+    cryptBuffer(a, blockMode, bIV, text.data(), buf.data(), text.size());
+    if (buf != out) {
+        cout << "CIPHER: buffer mismatch" << endl;
+        return;
+    }
+
+    buf = text;
+    cryptBuffer(a, blockMode, bIV, buf.data(), buf.data(), buf.size());
+    if (buf != out) {
+        cout << "CIPHER: in-place mismatch" << endl;
+        return;
+    }
+
+    cout << "CIPHER: " << asciiHex(out) << endl;
+}
+
+int main(int argc, char *argv[])
+{
+    size_t aesBits = 0;
+    string blockMode, key, IV;
+    vector<uint8_t> text;
+    bool bd = false, bt = false;
+    int opt;
+    while (-1 != (opt = getopt(argc, argv, "b:m:dk:i:t:"))) {
+        switch (opt) {
+
+        case ('b') : // AES key bits
+            {
+                stringstream ss(optarg);
+                if (!(ss >> aesBits)) {
+                    cerr << "error: AES bits " << optarg << endl;
+                    exit(EXIT_FAILURE);
+                }
+            }
+            break;
+
+        case ('m') : // block mode
+            blockMode = optarg;
+            break;
+
+        case ('d') : // decrypt
+            bd = true;
+            break;
+
+        case ('k') : // key
+            key = optarg;
+            break;
+
+        case ('i') : // initialization value
+            IV = optarg;
+            break;
+
+        case ('t') : // text
+            if (!asciiHexToVector(optarg, text)) {
+                cerr << "error: text in hex: " << optarg << endl;
+                exit(EXIT_FAILURE);
+            }
+            bt = true;
+            break;
+
+        default :
+            printUsage(argv[0]);
+        }
+    }
+
+    if (("ECB" != blockMode) &&
+        ("CBC" != blockMode) &&
+        ("OFB" != blockMode) &&
+        ("CFB" != blockMode)) {
+        printUsage(argv[0]);
+    }
+
+    // decryption in OFB and CFB modes is the forward cipher
+    const bool inverse = bd && ("ECB" == blockMode || "CBC" == blockMode);
+
+    if (bt && !key.empty()) {
+        switch (aesBits) {
+        case (128) :
+            if (inverse) runCipher<UNAES128>(blockMode, key, IV, text);
+            else runCipher<AES128>(blockMode, key, IV, text);
+            return EXIT_SUCCESS;
+
+        case (192) :
+            if (inverse) runCipher<UNAES192>(blockMode, key, IV, text);
+            else runCipher<AES192>(blockMode, key, IV, text);
+            return EXIT_SUCCESS;
+
+        case (256) :
+            if (inverse) runCipher<UNAES256>(blockMode, key, IV, text);
+            else runCipher<AES256>(blockMode, key, IV, text);
+            return EXIT_SUCCESS;
+        }
+    }
+
+    printUsage(argv[0]);
+}
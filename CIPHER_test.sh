@@ -0,0 +1,82 @@
+#!/bin/bash
+
+# Expected values are the AES examples of NIST SP 800-38A appendix F. CFB
+# is checked on the first block. The 17-block messages (two batches of
+# eight and one more block) are encrypted with the same keys and IV by
+# OpenSSL. Every case is also run into a separate buffer and in place.
+
+FAIL_COUNT=0
+
+P=6bc1bee22e409f96e93d7e117393172aae2d8a571e03ac9c9eb76fac45af8e5130c81c46a35ce411e5fbc1191a0a52eff69f2445df4f9b17ad2b417be66c3710
+IV=000102030405060708090a0b0c0d0e0f
+K128=2b7e151628aed2a6abf7158809cf4f3c
+K192=8e73b0f7da0e6452c810f32b809079e562f8ead2522c6b7b
+K256=603deb1015ca71be2b73aef0857d77811f352c073b6108d72d9810a30914dff4
+
+# N bytes of 0, 1, 2, ... modulo 251 in hex
+pattern() {
+    awk -v n=$1 'BEGIN { for (i = 0; i < n; ++i) printf "%02x", i % 251 }'
+}
+
+Q=`pattern 272`
+
+# checkCipher bits mode key IV plaintext ciphertext
+#
+# Encrypts the plaintext and decrypts the ciphertext.
+checkCipher() {
+    OPT_IV=""
+    if [ -n "$4" ]
+    then
+        OPT_IV="-i $4"
+    fi
+
+    CT=`./CIPHER_test -b $1 -m $2 -k $3 $OPT_IV -t $5 | awk '{print $2}'`
+    PT=`./CIPHER_test -b $1 -m $2 -d -k $3 $OPT_IV -t $6 | awk '{print $2}'`
+
+    if [ "$CT" == "$6" ] && [ "$PT" == "$5" ]
+    then
+        echo "OK AES"$1" "$2" "$6
+    else
+        echo "FAIL AES"$1" "$2" "$6
+        FAIL_COUNT=`expr $FAIL_COUNT + 1`
+    fi
+}
+
+# F.1 ECB
+checkCipher 128 ECB $K128 "" $P 3ad77bb40d7a3660a89ecaf32466ef97f5d3d58503b9699de785895a96fdbaaf43b1cd7f598ece23881b00e3ed0306887b0c785e27e8ad3f8223207104725dd4
+checkCipher 192 ECB $K192 "" $P bd334f1d6e45f25ff712a214571fa5cc974104846d0ad3ad7734ecb3ecee4eefef7afd2270e2e60adce0ba2face6444e9a4b41ba738d6c72fb16691603c18e0e
+checkCipher 256 ECB $K256 "" $P f3eed1bdb5d2a03c064b5a7e3db181f8591ccb10d410ed26dc5ba74a31362870b6ed21b99ca6f4f9f153e7b1beafed1d23304b7a39f9f3ff067d8d8f9e24ecc7
+
+# F.2 CBC
+checkCipher 128 CBC $K128 $IV $P 7649abac8119b246cee98e9b12e9197d5086cb9b507219ee95db113a917678b273bed6b8e3c1743b7116e69e222295163ff1caa1681fac09120eca307586e1a7
+checkCipher 192 CBC $K192 $IV $P 4f021db243bc633d7178183a9fa071e8b4d9ada9ad7dedf4e5e738763f69145a571b242012fb7ae07fa9baac3df102e008b0e27988598881d920a9e64f5615cd
+checkCipher 256 CBC $K256 $IV $P f58c4c04d6e5f1ba779eabfb5f7bfbd69cfc4e967edb808d679f777bc6702c7d39f23369a9d9bacfa530e26304231461b2eb05e2c39be9fcda6c19078c6a9d1b
+
+# F.3 CFB
+checkCipher 128 CFB $K128 $IV ${P:0:32} 3b3fd92eb72dad20333449f8e83cfb4a
+checkCipher 192 CFB $K192 $IV ${P:0:32} cdc80d6fddf18cab34c25909c99a4174
+checkCipher 256 CFB $K256 $IV ${P:0:32} dc7e84bfda79164b7ecd8486985d3860
+
+# F.4 OFB
+checkCipher 128 OFB $K128 $IV $P 3b3fd92eb72dad20333449f8e83cfb4a7789508d16918f03f53c52dac54ed8259740051e9c5fecf64344f7a82260edcc304c6528f659c77866a510d9c1d6ae5e
+checkCipher 192 OFB $K192 $IV $P cdc80d6fddf18cab34c25909c99a4174fcc28b8d4c63837c09e81700c11004018d9a9aeac0f6596f559c6d4daf59a5f26d9f200857ca6c3e9cac524bd9acc92a
+checkCipher 256 OFB $K256 $IV $P dc7e84bfda79164b7ecd8486985d38604febdc6740d20b3ac88f6ad82a4fb08d71ab47a086e86eedf39d1c5bba97c4080126141d67f37be8538f5a8be740e484
+
+# 17 blocks
+checkCipher 128 ECB $K128 "" $Q 50fe67cc996d32b6da0937e99bafec60c84af0b613435d5d9182801a9bd9320b25f33f023d8e724c675044e80b1934985ce99ca02f4e9733f193bf28000bd44c576076a2e3950d73f8e9bf794a7b5d95c34ab882088b5393daa9a661d69034366f8db13c3b464e73ddf4e248ed2967933459d4ca18c19941b910aea3c3490777637175e242b86544733697827da6de91f96dd3e427dae3a4b2ce3678d0ccb5a4c0234de8db1fbebbd9abbbd5f033c2a09fa549baf7dd513b15762222ecfe316e758d4d380b64237d308d82b0e810c65f4607cd680690e26d9fba228d8369d7f1f6a3569dea3cda208eb3d5792942612be39c6a7084e334e779e2326e9acbbe093ef2cd1300970723911a1c5a49e79698
+checkCipher 192 ECB $K192 "" $Q a609b38df3b1133dddff2718ba09565e848a6fa7d2b3567bf57371a1a030e9de6506b1642f4eb6b27135e31f7aee34988a6d4092ddc88bf0a24a40aa8bae3f3cfc90b4b120881f0e9be0c87745a948b35dfc015d6a6aec622236d2eacb789be8a30e2117c323d8555cada1a1bb703c1604f9de041cd67e031ca5d6e00a01b84df770d81b4aeec73ad859a75c307685a5e36b65bfc98280533491d39792cce37bc7dc8ff64b209ae613cb155180396691758a543bdfe7bd3d615b74f3a60208d008ba081f523eb6ec3007ac01014e8881b30a37f135ed31b80e920781c12410edb6cdd759a5c0efeab2bfdca400d37e647a453039d1e5eac70277613909231e372e20a58fa941f20e149af62ff80da1bf
+checkCipher 256 ECB $K256 "" $Q b7bf3a5df43989dd97f0fa97ebce2f4a7e9248e5d829ca7593f0c549db2f5b8c1a607c95e3456bf4ab9e64bf5caf30d2a37f597d1c79a5c13312cd6c9b70191dfee98812dac74950015c2d355ff112725c047596c9da44c8b9bbab1155b5d37b9d67e80f37ae900ae3f44c0d81ea6cc0ca8592e94625e2a7e713343914ccb631b7a1d68643405d5b3cdc766143fa489c3aa2c546e5ad105810ba50a0beb050fd094f422ff23dc1b7e2bacabd0dcc66f80cb350f9c3648a3d066ec2f3f78a92255c0395b8cf2c6305779dd8a68a52fc6f53a607e86d4ab77103be18c991b4cb62591029526e120a25933418ac5e54c896d9367436726e873494b8667995fcd5983402f35e8f59b29dbaf58d5450be3ee6
+checkCipher 128 CBC $K128 $IV $Q 7df76b0c1ab899b33e42f047b91b546f1caa8018c80b15b8e7aea82794adcb00bbc1e295910b9de4f1358dcb4213bdd8eefa3154215f4709af46573fc8cb07b9860dc1dd67ddfd952b41e3aa0cc47a9648738534d37e5e29ae2135af7532e41c1428b847ec6248fa03568d55163aa89885e757fd9c61999178f96a3c78f26befff9a03691d10ad992b32f674d03094a69b14874126563f8ff0a303378a36cbdd861aa9234286fac875aee498d4f0aa1f3968ad1a8d0b1907b2b970e55014600b020a1d3bd59d55a9eaaef67ee20574080bc9ebc7e26385cd4a6333b432f428bfa19e1a6ba1caadeec516ae5bcf662e8f8d10e5733f2323fd403033e46bffa34f641c3bae5c0b3a31e67344d54d823458
+checkCipher 192 CBC $K192 $IV $Q 22452d8e49a8a5939f7321ceea6d514bf48a9cd188e45a90df260d189693865e5e675acc497f91df6acbfa5a9d159c7c31ac2518344a7df61163e0f4d5194f9f1b5bf9d6d3c795a972c3e544d4a8da71e1cbe923441233ef9228d86db15bf71a988dcc8d1d902b136795e93af08915167412267de9de9c80daf5f7aeec63e3e41864d4813637c3a533cf94ddd098c7fdb8d2053b671ca1d85c660d0a4da2caab6c710d21569abc42bb3f03bc26eadd33522493058167043fe282c00268bf2de2bbafc405379cb7b0417c8ee3d922c641014d35f6986a1d996028cb2b74ba0c401bfb7615a2cc3593fe6e62627d5109ffc9cb5e29474b5fee48a14be2e71b23a446e77bc8765210eb1bc6b6cc46396726
+checkCipher 256 CBC $K256 $IV $Q e568f68194cf76d6174d4cc04310a854d09ef932b9ff1244ec7a1dc1ccb1c637573bd29fbd6fb3179897aa76a70b5519284f1339bec2004df1c51b33b56d39b4bdef8d50881d977914e6c57dd4c8c34167d3c1c69cc0cd1bc7dadf9a45accc6dbf69e322ad69df01667a1386f270eab4cda45b986c91e9f7c5d5ac9f6103bc96f9bdf40de54296114b2a13ed5e70226ec54309c9362511093f9979857e395301a3367eca76953cc07943ca091ff4c233e32085a17f32adeb0e8e089cd3583bd1b6c3d3c7aa94db67c2da0210656a05f0b229dfe8ec7bbeef1598351ffccf2af6b5ae01bacda2cea0862ed98d86fd4b6e893dfafaace5108f617757257cd9e53a2060c110e385a5e3a28cde004e6a4a02
+checkCipher 128 OFB $K128 $IV $Q 50ff65cf9d6834b1d2003de297a2e26fc9b5c8c91c8735887392276d9cfc486b87a93b7b1b262ec08e961c9a1447910cf6e2735e1d236a58f3b76b991b87a7712adbd8a17fdb0192843428a8344e5a4466c757d2744edebbf90e3b4f63e49fb5b9d1d4912c39698d9724d512733cd0c7b1fe7b5e6b782ac9077fc9417cc8538610bef9cc5e928329251bfbaffd36473e55ef21c81ea62c3e851743ed392205f7bf40d5e52b036143fc6180de52af51ebd5ee48eaadadbde7ff211fd00081c4bf14bccd027911bfffccff5317f8521668a4dd884b120efb363d51711cd9a0b62e2d130849cce4c90caf7887d0a8aa243993b9219200b2bf7dc9f1cfb4d7b9f1c563790bf9e97e1c9a745021553f708643
+checkCipher 192 OFB $K192 $IV $Q a608b18ef7b4153ad5f62d13b604585142fe13c9467539f78f4662b798a2944f9d73a48f478f9b59984e867f997ed932ab31367ebcb0c11e09be290b03fdc005c8f9a7f03c670bb877e240949bbbc89421d431e869602cf8376f0b8fa2880597d92305fd3b5bcfd5dbda295a0bd37178a076175fce35348e71e936c79e44640d1bb4aaa7edb8d593c2b414e01ed7745a5760c0f6f6dc86e9991165c49d47ee0da419cf9cc9801f80067692823b8dd5a82ddfa01dd64ddf6c9e03a9ebf78648f5ff74b65b3897d693a42044d8584dcb1d6326bbb5d5ea8cd37e095ffe306b6c0121195a380525ad376f969e0fa30ad1897248ba4342bceeb95624991badf095718234196d965eaa268510ec70d1165d3f
+checkCipher 256 OFB $K256 $IV $Q b7be385ef03c8fda9ff9f09ce7c32145f1d744234ac4b1b14e211f6f73fd20c3614279c50191acdb3e4ff7698cb0b8c8c788026b8c89d6c8c69d21cb3d11edab619ee08c51026f742cd6179a7193148ff9b1299d9d1fe3ee7838f1aa160ae6a191b4b1cdcd2f633db63975e7315a2007c7a7ffc7daa13179d47ab863e70594b5685ec059e21b873cc300a033bd0a9407506c039b9596eb1e1458e016eeee4c0c86a6daa03222139fb13f36ad0d022132687bf033d838506010e40139bfc795961bc69d1744aa2802a0f9a37424854e17f7a4a2b9942c4ea470c574b6675763d115232160de327f2a048506a047a164683e1abec4805e2db098f6f839be3eec98f6242401bc34a2379df279f666e236ec
+
+echo
+if [ $FAIL_COUNT == 0 ]
+then
+    echo All tests passed
+else
+    echo "There were "$FAIL_COUNT" failures"
+fi
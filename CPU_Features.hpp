@@ -0,0 +1,85 @@
+#ifndef _CRYPTL_CPU_FEATURES_HPP_
+#define _CRYPTL_CPU_FEATURES_HPP_
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define CRYPTL_X86_64
+#include <cpuid.h>
+#endif
+
+namespace cryptl {
+
+////////////////////////////////////////////////////////////////////////////////
+// runtime detection of instruction set extensions
+//
+// Queried once, every later call is a load of a cached result. Compile with
+// CRYPTL_NO_ACCEL defined to always take the portable code paths.
+//
+
+class CPU_Features
+{
+public:
+    // SHA-NI: sha256rnds2, sha256msg1, sha256msg2 (with SSE4.1)
+    static bool hasSHA() {
+        return features().m_SHA;
+    }
+
+    // AES-NI: aesenc, aesdec, aeskeygenassist (with SSE4.1)
+    static bool hasAES() {
+        return features().m_AES;
+    }
+
+    static bool hasAVX2() {
+        return features().m_AVX2;
+    }
+
+    static bool hasAVX512() {
+        return features().m_AVX512;
+    }
+
+private:
+    CPU_Features()
+        : m_SHA(false),
+          m_AES(false),
+          m_AVX2(false),
+          m_AVX512(false)
+    {
+#if defined(CRYPTL_X86_64) && !defined(CRYPTL_NO_ACCEL)
+        unsigned int eax, ebx, ecx, edx;
+
+        if (! __get_cpuid(1, &eax, &ebx, &ecx, &edx)) return;
+
+        const bool
+            SSE41 = ecx & bit_SSE4_1,
+            AESNI = ecx & bit_AES,
+            OSXSAVE = ecx & bit_OSXSAVE;
+
+        // operating system saves YMM and ZMM registers
+        bool YMM = false, ZMM = false;
+        if (OSXSAVE) {
+            unsigned int xcr0_lo, xcr0_hi;
+            __asm__ ("xgetbv" : "=a" (xcr0_lo), "=d" (xcr0_hi) : "c" (0));
+            YMM = 0x6 == (xcr0_lo & 0x6);
+            ZMM = 0xe6 == (xcr0_lo & 0xe6);
+        }
+
+        m_AES = SSE41 && AESNI;
+
+        if (! __get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) return;
+
+        m_SHA = SSE41 && (ebx & bit_SHA);
+        m_AVX2 = YMM && (ebx & bit_AVX2);
+        m_AVX512 = m_AVX2 && ZMM && (ebx & bit_AVX512F);
+#endif
+    }
+
+    static const CPU_Features& features() {
+        static const CPU_Features a;
+        return a;
+    }
+
+    bool m_SHA, m_AES, m_AVX2, m_AVX512;
+};
+
+} // namespace cryptl
+
+#endif
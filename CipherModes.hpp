@@ -1,171 +1,357 @@
 #ifndef _CRYPTL_CIPHER_MODES_HPP_
 #define _CRYPTL_CIPHER_MODES_HPP_
 
+#include <array>
 #include <cassert>
 #include <cstdint>
+#include <type_traits>
 #include <vector>
 
+#include <cryptl/Wipe.hpp>
+
 namespace cryptl {
 
+////////////////////////////////////////////////////////////////////////////////
+// block cipher with an expanded key
+//
+// T is: AES128, AES192, AES256, UNAES128, UNAES192, UNAES256
+//
+// The key schedule and the round keys derived from it for the backend in
+// use (e.g. decryption or bitsliced round keys) are computed once when the
+// key is set, so messages after the first only pay for their own blocks.
+// The modes only read a context, one const context may be shared between
+// threads. Setting the key while another thread uses the context is a race.
+// Without a key, the schedule and round keys are all zero. The schedule is
+// wiped when the key changes and on destruction.
+//
+
+template <typename T>
+class CipherContext
+{
+public:
+    typedef typename T::KeyType KeyType;
+    typedef typename T::ScheduleType ScheduleType;
+    typedef typename T::Algo Algo;
+    typedef typename Algo::RoundKeys RoundKeys;
+
+    CipherContext()
+        : m_schedule()
+    {}
+
+    explicit CipherContext(const KeyType& key)
+        : m_schedule()
+    {
+        setKey(key);
+    }
+
+    ~CipherContext() {
+        wipeIfPlain(m_schedule);
+    }
+
+    void setKey(const KeyType& key) {
+        wipeIfPlain(m_schedule);
+
+        typename T::KeyExpansion keyExpand;
+        keyExpand(key, m_schedule);
+        m_roundKeys.set(m_schedule);
+    }
+
+    const ScheduleType& schedule() const { return m_schedule; }
+    const RoundKeys& roundKeys() const { return m_roundKeys; }
+    const Algo& algo() const { return m_algo; }
+
+private:
+    ScheduleType m_schedule;
+    RoundKeys m_roundKeys;
+    Algo m_algo;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// independent blocks through a cipher
+//
+// Elements of the cipher's own type go straight from and to the caller's
+// memory. Any other element type is copied through a batch buffer.
+//
+
+template <typename ALGO,
+          typename U,
+          bool DIRECT = std::is_same<U, typename ALGO::VarType>::value>
+class CipherBlocks
+{
+public:
+    // n blocks
+    template <typename W>
+    static void crypt(const ALGO& algo,
+                      const W& w,
+                      const typename ALGO::RoundKeys& rk,
+                      const U* in,
+                      U* out,
+                      const std::size_t n)
+    {
+        typename ALGO::BatchType inBatch, outBatch;
+        const std::size_t B = typename ALGO::BlockType().size();
+        const std::size_t P = inBatch.size() / B;
+
+        for (std::size_t i = 0; i < n; i += P) {
+            const std::size_t offset = i * B;
+            const std::size_t count = n - i < P ? n - i : P;
+
+            for (std::size_t j = 0; j < count * B; ++j)
+                inBatch[j] = in[j + offset];
+
+            algo(inBatch.data(), outBatch.data(), count, w, rk);
+
+            for (std::size_t j = 0; j < count * B; ++j)
+                out[j + offset] = outBatch[j];
+        }
+    }
+};
+
+template <typename ALGO, typename U>
+class CipherBlocks<ALGO, U, true>
+{
+public:
+    template <typename W>
+    static void crypt(const ALGO& algo,
+                      const W& w,
+                      const typename ALGO::RoundKeys& rk,
+                      const U* in,
+                      U* out,
+                      const std::size_t n)
+    {
+        algo(in, out, n, w, rk);
+    }
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 // block cipher modes
 //
+// Each mode takes either a CipherContext or a key, the key is expanded for
+// that one call. The text is either a vector, with the result returned in a
+// new vector, or n elements at in written to out. The second form allocates
+// nothing and out may be the same as in.
+//
 
 // electronic code book mode (ECB)
 template <typename T, typename U>
-std::vector<U> ECB(T dummy,
-                   const typename T::KeyType& key,
-                   const std::vector<U>& inText)
+void ECB(const CipherContext<T>& ctx,
+         const U* in,
+         U* out,
+         const std::size_t n)
 {
-    typename T::ScheduleType scheduleBlock;
-    typename T::KeyExpansion keyExpand;
-    keyExpand(key, scheduleBlock);
-
-    typename T::BlockType inBlock, outBlock;
-    const std::size_t B = inBlock.size();
-    const std::size_t N = inText.size() / B;
+    const std::size_t B = typename T::BlockType().size();
+    const std::size_t N = n / B;
 #ifdef USE_ASSERT
     // even number of blocks
-    assert(N * B == inText.size());
+    assert(N * B == n);
 #endif
-    std::vector<U> outText(inText.size());
-
-    typename T::Algo algo;
-    for (std::size_t i = 0; i < N; ++i) {
-        const std::size_t offset = i * B;
-
-        for (std::size_t j = 0; j < B; ++j)
-            inBlock[j] = inText[j + offset];
 
-        algo(inBlock, outBlock, scheduleBlock);
-
-        for (std::size_t j = 0; j < B; ++j)
-            outText[j + offset] = outBlock[j];
-    }
+    // blocks are independent, several per call
+    CipherBlocks<typename T::Algo, U>::crypt(
+        ctx.algo(), ctx.schedule(), ctx.roundKeys(), in, out, N);
+}
 
+template <typename T, typename U>
+std::vector<U> ECB(const CipherContext<T>& ctx,
+                   const std::vector<U>& inText)
+{
+    std::vector<U> outText(inText.size());
+    ECB(ctx, inText.data(), outText.data(), inText.size());
     return outText;
 }
 
-// cipher block chaining mode (CBC)
 template <typename T, typename U>
-std::vector<U> CBC(T dummy,
+std::vector<U> ECB(T dummy,
                    const typename T::KeyType& key,
-                   const typename T::BlockType& IV,
                    const std::vector<U>& inText)
 {
-    typename T::ScheduleType scheduleBlock;
-    typename T::KeyExpansion keyExpand;
-    keyExpand(key, scheduleBlock);
+    return ECB(CipherContext<T>(key), inText);
+}
+
+// cipher block chaining mode (CBC)
+template <typename T, typename U>
+void CBC(const CipherContext<T>& ctx,
+         const typename T::BlockType& IV,
+         const U* in,
+         U* out,
+         const std::size_t n)
+{
+    const auto& scheduleBlock = ctx.schedule();
+    const auto& roundKeys = ctx.roundKeys();
 
     typename T::BlockType inBlock, outBlock, lastBlock = IV;
     const std::size_t B = inBlock.size();
-    const std::size_t N = inText.size() / B;
+    const std::size_t N = n / B;
 #ifdef USE_ASSERT
     // even number of blocks
-    assert(N * B == inText.size());
+    assert(N * B == n);
 #endif
-    std::vector<U> outText(inText.size());
 
-    typename T::Algo algo;
-    for (std::size_t i = 0; i < N; ++i) {
-        const std::size_t offset = i * B;
+    const auto& algo = ctx.algo();
+    if (T::isEncryption()) {
+        for (std::size_t i = 0; i < N; ++i) {
+            const std::size_t offset = i * B;
 
-        if (T::isEncryption()) {
             for (std::size_t j = 0; j < B; ++j)
-                inBlock[j] = inText[j + offset] ^ lastBlock[j];
+                inBlock[j] = in[j + offset] ^ lastBlock[j];
 
-            algo(inBlock, outBlock, scheduleBlock);
+            algo(inBlock, outBlock, scheduleBlock, roundKeys);
 
             for (std::size_t j = 0; j < B; ++j)
-                outText[j + offset] = outBlock[j];
+                out[j + offset] = outBlock[j];
 
             lastBlock = outBlock;
+        }
 
-        } else { // isDecryption
-            for (std::size_t j = 0; j < B; ++j)
-                inBlock[j] = inText[j + offset];
+    } else { // isDecryption
+        // ciphertext is all known, several blocks per call
+        std::array<U, std::tuple_size<typename T::Algo::BatchType>::value> cipherText;
+        const std::size_t P = cipherText.size() / B;
+
+        for (std::size_t i = 0; i < N; i += P) {
+            const std::size_t offset = i * B;
+            const std::size_t count = N - i < P ? N - i : P;
 
-            algo(inBlock, outBlock, scheduleBlock);
+            // kept for the XOR as out may be the same as in
+            for (std::size_t j = 0; j < count * B; ++j)
+                cipherText[j] = in[j + offset];
 
+            CipherBlocks<typename T::Algo, U>::crypt(
+                algo, scheduleBlock, roundKeys, in + offset, out + offset, count);
+
+            // previous ciphertext block, IV for the first
             for (std::size_t j = 0; j < B; ++j)
-                outText[j + offset] = outBlock[j] ^ lastBlock[j];
+                out[j + offset] = out[j + offset] ^ lastBlock[j];
+
+            for (std::size_t j = B; j < count * B; ++j)
+                out[j + offset] = out[j + offset] ^ cipherText[j - B];
 
-            lastBlock = inBlock;
+            for (std::size_t j = 0; j < B; ++j)
+                lastBlock[j] = cipherText[(count - 1) * B + j];
         }
     }
+}
 
+template <typename T, typename U>
+std::vector<U> CBC(const CipherContext<T>& ctx,
+                   const typename T::BlockType& IV,
+                   const std::vector<U>& inText)
+{
+    std::vector<U> outText(inText.size());
+    CBC(ctx, IV, inText.data(), outText.data(), inText.size());
     return outText;
 }
 
-// output feedback mode (OFB)
 template <typename T, typename U>
-std::vector<U> OFB(T dummy,
+std::vector<U> CBC(T dummy,
                    const typename T::KeyType& key,
                    const typename T::BlockType& IV,
                    const std::vector<U>& inText)
 {
-    typename T::ScheduleType scheduleBlock;
-    typename T::KeyExpansion keyExpand;
-    keyExpand(key, scheduleBlock);
+    return CBC(CipherContext<T>(key), IV, inText);
+}
+
+// output feedback mode (OFB)
+template <typename T, typename U>
+void OFB(const CipherContext<T>& ctx,
+         const typename T::BlockType& IV,
+         const U* in,
+         U* out,
+         const std::size_t n)
+{
+    const auto& scheduleBlock = ctx.schedule();
+    const auto& roundKeys = ctx.roundKeys();
 
     typename T::BlockType inBlock = IV, outBlock;
     const std::size_t B = inBlock.size();
-    const std::size_t N = inText.size() / B;
+    const std::size_t N = n / B;
 #ifdef USE_ASSERT
     // even number of blocks
-    assert(N * B == inText.size());
+    assert(N * B == n);
 #endif
-    std::vector<U> outText(inText.size());
 
-    typename T::Algo algo;
+    const auto& algo = ctx.algo();
     for (std::size_t i = 0; i < N; ++i) {
         const std::size_t offset = i * B;
 
-        algo(inBlock, outBlock, scheduleBlock);
+        algo(inBlock, outBlock, scheduleBlock, roundKeys);
         inBlock = outBlock;
 
         for (std::size_t j = 0; j < B; ++j)
-            outText[j + offset] = outBlock[j] ^ inText[j + offset];
+            out[j + offset] = outBlock[j] ^ in[j + offset];
     }
+}
 
+template <typename T, typename U>
+std::vector<U> OFB(const CipherContext<T>& ctx,
+                   const typename T::BlockType& IV,
+                   const std::vector<U>& inText)
+{
+    std::vector<U> outText(inText.size());
+    OFB(ctx, IV, inText.data(), outText.data(), inText.size());
     return outText;
 }
 
-// cipher feedback mode (CFB)
 template <typename T, typename U>
-std::vector<U> CFB(T dummy,
+std::vector<U> OFB(T dummy,
                    const typename T::KeyType& key,
                    const typename T::BlockType& IV,
                    const std::vector<U>& inText)
 {
-    typename T::ScheduleType scheduleBlock;
-    typename T::KeyExpansion keyExpand;
-    keyExpand(key, scheduleBlock);
+    return OFB(CipherContext<T>(key), IV, inText);
+}
+
+// cipher feedback mode (CFB)
+template <typename T, typename U>
+void CFB(const CipherContext<T>& ctx,
+         const typename T::BlockType& IV,
+         const U* in,
+         U* out,
+         const std::size_t n)
+{
+    const auto& scheduleBlock = ctx.schedule();
+    const auto& roundKeys = ctx.roundKeys();
 
     typename T::BlockType inBlock, outBlock, lastBlock = IV;
     const std::size_t B = inBlock.size();
-    const std::size_t N = inText.size() / B;
+    const std::size_t N = n / B;
 #ifdef USE_ASSERT
     // even number of blocks
-    assert(N * B == inText.size());
+    assert(N * B == n);
 #endif
-    std::vector<U> outText(inText.size());
 
-    typename T::Algo algo;
+    const auto& algo = ctx.algo();
     for (std::size_t i = 0; i < N; ++i) {
         const std::size_t offset = i * B;
 
         inBlock = lastBlock;
-        algo(inBlock, outBlock, scheduleBlock);
+        algo(inBlock, outBlock, scheduleBlock, roundKeys);
         lastBlock = T::isEncryption() ? outBlock : inBlock;
 
         for (std::size_t j = 0; j < B; ++j)
-            outText[j + offset] = outBlock[j] ^ inText[j + offset];
+            out[j + offset] = outBlock[j] ^ in[j + offset];
     }
+}
 
+template <typename T, typename U>
+std::vector<U> CFB(const CipherContext<T>& ctx,
+                   const typename T::BlockType& IV,
+                   const std::vector<U>& inText)
+{
+    std::vector<U> outText(inText.size());
+    CFB(ctx, IV, inText.data(), outText.data(), inText.size());
     return outText;
 }
 
+template <typename T, typename U>
+std::vector<U> CFB(T dummy,
+                   const typename T::KeyType& key,
+                   const typename T::BlockType& IV,
+                   const std::vector<U>& inText)
+{
+    return CFB(CipherContext<T>(key), IV, inText);
+}
+
 } // namespace cryptl
 
 #endif
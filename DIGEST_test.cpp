@@ -0,0 +1,375 @@
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "cryptl/ASCII_Hex.hpp"
+#include "cryptl/Bless.hpp"
+#include "cryptl/Digest.hpp"
+#include "cryptl/DigestBatch.hpp"
+#include "cryptl/SHA_1.hpp"
+#include "cryptl/SHA_224.hpp"
+#include "cryptl/SHA_256.hpp"
+#include "cryptl/SHA_256_Double.hpp"
+#include "cryptl/SHA_384.hpp"
+#include "cryptl/SHA_512.hpp"
+#include "cryptl/SHA_512_224.hpp"
+#include "cryptl/SHA_512_256.hpp"
+#include "cryptl/SHA_Stream.hpp"
+
+using namespace cryptl;
+using namespace std;
+
+void printUsage(const char* exeName) {
+    const string
+        A = " -a 1|224|256|384|512|512224|512256",
+        M = " -m message_in_hex",
+        N = " [-n batch_size]",
+        P = " -p words_per_append",
+        F = " -f prefix_bytes";
+
+    cerr << "SHA-256d: " << exeName << " -a 256 -d" << M << N << endl;
+    cerr << "batch:    " << exeName << A << " -b" << M << N << endl;
+    cerr << "append:   " << exeName << A << M << P << endl;
+    cerr << "fork:     " << exeName << A << M << F << endl;
+
+    exit(EXIT_FAILURE);
+}
+
+// batch of messages, the first is the one given, the others have a counter
+// byte appended
+vector<vector<uint8_t>> batchOf(const vector<uint8_t>& msg, const size_t batch)
+{
+    vector<vector<uint8_t>> a(batch, msg);
+    for (size_t k = 1; k < batch; ++k) a[k].push_back(k);
+    return a;
+}
+
+// double SHA-256 of one message, in a batch and of the first digest in
+// place must all agree with SHA-256 applied twice
+void runDouble(const vector<uint8_t>& msg, const size_t batch)
+{
+    const auto a = batchOf(msg, batch);
+
+    vector<SHA256::DigType> single(batch);
+    for (size_t k = 0; k < batch; ++k) {
+        const auto d = digest(SHA256(), a[k]);
+
+        vector<uint8_t> v(sizeof(d));
+        storeBigEndian(v.data(), d);
+
+        single[k] = digest(SHA256(), v);
+
+        if (single[k] != SHA_256_Double::hash(a[k])) {
+            cout << "SHA256D: single mismatch" << endl;
+            return;
+        }
+    }
+
+    if (SHA_256_Double::hash(a) != single) {
+        cout << "SHA256D: batch mismatch" << endl;
+        return;
+    }
+
+    // second pass in place
+    vector<SHA256::DigType> D(batch);
+    for (size_t k = 0; k < batch; ++k) D[k] = digest(SHA256(), a[k]);
+
+    SHA_256_Double::hashDigest(D.data(), batch, D.data());
+    if (D != single) {
+        cout << "SHA256D: in-place mismatch" << endl;
+        return;
+    }
+
+    cout << "SHA256D: " << asciiHex(single[0]) << endl;
+}
+
+// batch digest of messages of mixed lengths, each the same as on its own
+//
+// Message k is the first (61 k) mod (n + 1) bytes of the one given, so the
+// block counts are mixed within each group. The digest printed is of all
+// the batch digests one after another.
+template <typename T>
+void runBatch(const vector<uint8_t>& msg, const size_t batch)
+{
+    vector<ByteSpan> a;
+    for (size_t k = 0; k < batch; ++k)
+        a.emplace_back(msg.data(), (61 * k) % (msg.size() + 1));
+
+    const auto out = digest(T(), a);
+
+    string all;
+    for (size_t k = 0; k < batch; ++k) {
+        if (out[k] != digest(T(), a[k].data, a[k].size)) {
+            cout << "BATCH: single mismatch" << endl;
+            return;
+        }
+
+        all += asciiHex(out[k]);
+    }
+
+    vector<uint8_t> v;
+    asciiHexToVector(all, v);
+
+    cout << "BATCH: " << asciiHex(digest(T(), v)) << endl;
+}
+
+// message appended a few words at a time, the digest after each append
+// must be the same as the digest of the message so far
+template <typename T>
+void runAppend(const vector<uint8_t>& msg, const size_t piece)
+{
+    typedef typename T::WordType WordType;
+
+    const size_t W = sizeof(WordType);
+    if (0 != msg.size() % W) {
+        cout << "APPEND: message is not whole words" << endl;
+        return;
+    }
+
+    T hashAlgo;
+    typename T::DigType d;
+
+    // twice, starting over with clearMessage() in between
+    for (size_t pass = 0; pass < 2; ++pass) {
+        hashAlgo.clearMessage();
+
+        size_t i = 0;
+        do {
+            for (size_t k = 0; k < piece && i < msg.size(); ++k, i += W) {
+                WordType w;
+                blessBigEndian(w, msg.data() + i);
+                hashAlgo.msgInput(w);
+            }
+
+            hashAlgo.computeHashAppended();
+            d = hashAlgo.digest();
+
+            if (d != digest(T(), msg.data(), i)) {
+                cout << "APPEND: prefix mismatch" << endl;
+                return;
+            }
+        } while (i < msg.size());
+    }
+
+    cout << "APPEND: " << asciiHex(d) << endl;
+}
+
+// message with SHA padding: bit "1", zero bits, length in two words
+template <typename T>
+vector<uint8_t> padded(const vector<uint8_t>& msg)
+{
+    const size_t W = sizeof(typename T::WordType), BLOCK = 16 * W;
+
+    vector<uint8_t> v(msg);
+    v.push_back(0x80);
+    while (v.size() % BLOCK != BLOCK - 2 * W) v.push_back(0);
+
+    // length fits in the last eight bytes
+    for (size_t i = 8; i < 2 * W; ++i) v.push_back(0);
+
+    const uint64_t lengthBits = msg.size() * 8;
+    for (int i = 7; i >= 0; --i) v.push_back(lengthBits >> 8 * i);
+
+    return v;
+}
+
+// streamInput() words from a padded message
+template <typename T>
+void streamWords(T& hashAlgo, const uint8_t* p, const size_t n)
+{
+    typedef typename T::WordType WordType;
+
+    for (size_t i = 0; i < n; i += sizeof(WordType)) {
+        WordType w;
+        blessBigEndian(w, p + i);
+        hashAlgo.streamInput(w);
+    }
+}
+
+// Streams forked after a prefix: one finishes the message, one a different
+// suffix, and the original carries on. A hasher fed words of the padded
+// message is forked the same way. A stream resumed from the midstate at
+// the last block boundary in the prefix finishes the message too. All must
+// agree with hashing each message from the start.
+template <typename T>
+void runFork(const vector<uint8_t>& msg, const size_t prefix)
+{
+    if (prefix > msg.size()) {
+        cout << "FORK: prefix is longer than the message" << endl;
+        return;
+    }
+
+    const size_t rest = msg.size() - prefix;
+    const auto d = digest(T(), msg);
+
+    // other suffix, the rest of the message reversed plus one byte
+    vector<uint8_t> other(msg.begin(), msg.begin() + prefix);
+    other.insert(other.end(), msg.rbegin(), msg.rbegin() + rest);
+    other.push_back(0x5a);
+
+    SHA_Stream<T> s;
+    s.update(msg.data(), prefix);
+
+    auto a = s.fork();
+    auto b = s.fork();
+    a.update(msg.data() + prefix, rest);
+    b.update(other.data() + prefix, other.size() - prefix);
+    s.update(msg.data() + prefix, rest);
+
+    if (a.final() != d || b.final() != digest(T(), other) || s.final() != d) {
+        cout << "FORK: stream mismatch" << endl;
+        return;
+    }
+
+    // hasher, forked after the whole words of the prefix
+    const auto v = padded<T>(msg);
+    const size_t W = sizeof(typename T::WordType), split = prefix / W * W;
+
+    T h;
+    h.initHash();
+    streamWords(h, v.data(), split);
+
+    auto c = h.fork();
+    streamWords(c, v.data() + split, v.size() - split);
+    c.finalHash();
+
+    streamWords(h, v.data() + split, v.size() - split);
+    h.finalHash();
+
+    if (c.digest() != d || h.digest() != d) {
+        cout << "FORK: hasher mismatch" << endl;
+        return;
+    }
+
+    // midstate at a block boundary
+    const size_t boundary = prefix / (16 * W) * (16 * W);
+
+    SHA_Stream<T> e;
+    e.update(msg.data(), boundary);
+
+    SHA_Stream<T> f(e.midstate());
+    f.update(msg.data() + boundary, msg.size() - boundary);
+
+    if (f.final() != d) {
+        cout << "FORK: midstate mismatch" << endl;
+        return;
+    }
+
+    cout << "FORK: " << asciiHex(d) << endl;
+}
+
+int main(int argc, char *argv[])
+{
+    size_t shaBits = 0, batch = 1, piece = 0, prefix = 0;
+    vector<uint8_t> msg;
+    bool bd = false, bb = false, bm = false, bf = false;
+    int opt;
+    while (-1 != (opt = getopt(argc, argv, "a:dbm:n:p:f:"))) {
+        switch (opt) {
+
+        case ('a') : // algorithm
+            {
+                stringstream ss(optarg);
+                if (!(ss >> shaBits)) {
+                    cerr << "error: algorithm " << optarg << endl;
+                    exit(EXIT_FAILURE);
+                }
+            }
+            break;
+
+        case ('d') : // double hash
+            bd = true;
+            break;
+
+        case ('b') : // batch digest
+            bb = true;
+            break;
+
+        case ('m') : // message
+            if (!asciiHexToVector(optarg, msg)) {
+                cerr << "error: message in hex: " << optarg << endl;
+                exit(EXIT_FAILURE);
+            }
+            bm = true;
+            break;
+
+        case ('n') : // batch size
+            {
+                stringstream ss(optarg);
+                if (!(ss >> batch) || 0 == batch) {
+                    cerr << "error: batch size " << optarg << endl;
+                    exit(EXIT_FAILURE);
+                }
+            }
+            break;
+
+        case ('p') : // words per append
+            {
+                stringstream ss(optarg);
+                if (!(ss >> piece) || 0 == piece) {
+                    cerr << "error: words per append " << optarg << endl;
+                    exit(EXIT_FAILURE);
+                }
+            }
+            break;
+
+        case ('f') : // prefix bytes
+            {
+                stringstream ss(optarg);
+                if (!(ss >> prefix)) {
+                    cerr << "error: prefix bytes " << optarg << endl;
+                    exit(EXIT_FAILURE);
+                }
+            }
+            bf = true;
+            break;
+
+        default :
+            printUsage(argv[0]);
+        }
+    }
+
+    if (bd && bm && 256 == shaBits) {
+        runDouble(msg, batch);
+        return EXIT_SUCCESS;
+
+    } else if (bb && bm) {
+        switch (shaBits) {
+        case (1) : runBatch<SHA1>(msg, batch); return EXIT_SUCCESS;
+        case (224) : runBatch<SHA224>(msg, batch); return EXIT_SUCCESS;
+        case (256) : runBatch<SHA256>(msg, batch); return EXIT_SUCCESS;
+        case (384) : runBatch<SHA384>(msg, batch); return EXIT_SUCCESS;
+        case (512) : runBatch<SHA512>(msg, batch); return EXIT_SUCCESS;
+        case (512224) : runBatch<SHA512_224>(msg, batch); return EXIT_SUCCESS;
+        case (512256) : runBatch<SHA512_256>(msg, batch); return EXIT_SUCCESS;
+        }
+
+    } else if (bm && 0 != piece) {
+        switch (shaBits) {
+        case (1) : runAppend<SHA1>(msg, piece); return EXIT_SUCCESS;
+        case (224) : runAppend<SHA224>(msg, piece); return EXIT_SUCCESS;
+        case (256) : runAppend<SHA256>(msg, piece); return EXIT_SUCCESS;
+        case (384) : runAppend<SHA384>(msg, piece); return EXIT_SUCCESS;
+        case (512) : runAppend<SHA512>(msg, piece); return EXIT_SUCCESS;
+        case (512224) : runAppend<SHA512_224>(msg, piece); return EXIT_SUCCESS;
+        case (512256) : runAppend<SHA512_256>(msg, piece); return EXIT_SUCCESS;
+        }
+
+    } else if (bm && bf) {
+        switch (shaBits) {
+        case (1) : runFork<SHA1>(msg, prefix); return EXIT_SUCCESS;
+        case (224) : runFork<SHA224>(msg, prefix); return EXIT_SUCCESS;
+        case (256) : runFork<SHA256>(msg, prefix); return EXIT_SUCCESS;
+        case (384) : runFork<SHA384>(msg, prefix); return EXIT_SUCCESS;
+        case (512) : runFork<SHA512>(msg, prefix); return EXIT_SUCCESS;
+        case (512224) : runFork<SHA512_224>(msg, prefix); return EXIT_SUCCESS;
+        case (512256) : runFork<SHA512_256>(msg, prefix); return EXIT_SUCCESS;
+        }
+    }
+
+    printUsage(argv[0]);
+}
@@ -0,0 +1,169 @@
+#!/bin/bash
+
+# Expected digests are computed with Python hashlib. Batches of 17 messages
+# fill the SIMD lanes with a remainder. In double SHA-256 batches, the
+# messages after the first have a counter byte appended. In batch digests,
+# message k is the first (61 k) mod 1001 bytes of the 1000-byte pattern and
+# the expected value is the digest of all the batch digests in order. The
+# batch of 1100 is more than one group of 1024.
+
+FAIL_COUNT=0
+
+# text as hexadecimal octets
+hex() {
+    echo -n "$1" | od -An -v -tx1 | tr -d ' \n'
+}
+
+# octet in hex repeated N times
+rep() {
+    printf "$1%.0s" `seq 1 $2`
+}
+
+# N bytes of 0, 1, 2, ... modulo 251 in hex
+pattern() {
+    awk -v n=$1 'BEGIN { for (i = 0; i < n; ++i) printf "%02x", i % 251 }'
+}
+
+# checkDouble message expected_digest
+checkDouble() {
+    for N in 1 17
+    do
+        MD=`./DIGEST_test -a 256 -d -m "$1" -n $N | awk '{print $2}'`
+        if [ "$MD" == "$2" ]
+        then
+            echo "OK SHA256D x"$N" "$2
+        else
+            echo "FAIL SHA256D x"$N" "$2
+            FAIL_COUNT=`expr $FAIL_COUNT + 1`
+        fi
+    done
+}
+
+# checkBatch bits batch_size expected_digest
+checkBatch() {
+    MD=`./DIGEST_test -a $1 -b -m \`pattern 1000\` -n $2 | awk '{print $2}'`
+    if [ "$MD" == "$3" ]
+    then
+        echo "OK SHA"$1" batch x"$2" "$3
+    else
+        echo "FAIL SHA"$1" batch x"$2" "$3
+        FAIL_COUNT=`expr $FAIL_COUNT + 1`
+    fi
+}
+
+# checkAppend bits message_bytes expected_digest
+#
+# The message goes in 1, 3, 16 and 40 words at a time, digest after each.
+checkAppend() {
+    for P in 1 3 16 40
+    do
+        MD=`./DIGEST_test -a $1 -m "\`pattern $2\`" -p $P | awk '{print $2}'`
+        if [ "$MD" == "$3" ]
+        then
+            echo "OK SHA"$1" "$2" bytes appended "$P" words at a time"
+        else
+            echo "FAIL SHA"$1" "$2" bytes appended "$P" words at a time"
+            FAIL_COUNT=`expr $FAIL_COUNT + 1`
+        fi
+    done
+}
+
+# checkFork bits expected_digest_of_1000_bytes
+#
+# Forked and resumed at prefixes on and off the word and block boundaries.
+checkFork() {
+    for F in 0 1 63 64 100 128 999 1000
+    do
+        MD=`./DIGEST_test -a $1 -m \`pattern 1000\` -f $F | awk '{print $2}'`
+        if [ "$MD" == "$2" ]
+        then
+            echo "OK SHA"$1" forked after "$F" bytes"
+        else
+            echo "FAIL SHA"$1" forked after "$F" bytes"
+            FAIL_COUNT=`expr $FAIL_COUNT + 1`
+        fi
+    done
+}
+
+# SHA-256(SHA-256(message))
+checkDouble "" 5df6e0e2761359d30a8275058e299fcc0381534545f55cf43e41983f5d4c9456
+checkDouble `hex abc` 4f8b42c22dd3729b519ba6f68d2da7cc5b2d606d05daed5ad5128cc03e6c6358
+checkDouble `rep 61 56` 122cf0fa8f81dae14842491eedeab26374370514f6c4413bcc32352ae586b39e
+checkDouble `pattern 1000` c88e98bd565d6e001a0a37ac287032e1183923f35f6fde42c14210cbe2098d7c
+
+# batch digests of mixed lengths
+checkBatch 1 1 be1bdec0aa74b4dcb079943e70528096cca985f8
+checkBatch 1 17 21246c454d531fd0ac15cd7352326514cd367bb5
+checkBatch 1 1100 4698b8c26a53e5fab99e0908ab30b2467deadd53
+
+checkBatch 224 1 4126b5221637da7df60d24eaa2822a0a1a19a4c2c4cfa7f1034475be
+checkBatch 224 17 c349a89ea846fd533a978cda22377358e32d64730d826350287aa4df
+checkBatch 224 1100 2e402fe1b87acf18475c04bd9d420dcadd1c59fc91ef04997904ced7
+
+checkBatch 256 1 5df6e0e2761359d30a8275058e299fcc0381534545f55cf43e41983f5d4c9456
+checkBatch 256 17 38ce975afa4b54abf087e327ce334c1c0f31ac029b67cc86085a2f39f222c685
+checkBatch 256 1100 639968db0d2859ed92d84b1013c5b5e95021ca789ff47a4531882eb3d4791c08
+
+checkBatch 384 1 b035c6baed2533e26bda63b69d2e45daa9d14ecdf7118feb40e912d14b4355114c00f3989e07a23aeacbf07e9872f7db
+checkBatch 384 17 9732907d1119af7a03a1f205342f0baff9d35c684c1625d068441a3e6889e515d5fa7174022369de576df735df393c3d
+checkBatch 384 1100 74ae0b6e20803cf526d78978609a3ad6986412ee49c334fc43e0d748b5d4fb3044a1c7e998077d4a7f484709cc256f5a
+
+checkBatch 512 1 826df068457df5dd195b437ab7e7739ff75d2672183f02bb8e1089fabcf97bd9dc80110cf42dbc7cff41c78ecb68d8ba78abe6b5178dea3984df8c55541bf949
+checkBatch 512 17 5bffe27acea8dfded329bfef6deb984a9080da625740fe8f55d33b1e16bc2077798ff1cd9677bbad84a5cbdcb3154969b938759b6d114081fcc606370f87ab9e
+checkBatch 512 1100 b20580a646c2ef7c7898a5161974e8d25fc8033054c357bc84e0717279ef06f5c09818dd869af0516748d78d15deda9e4ef9132c76b8dca2c67a036d726e53ac
+
+checkBatch 512224 1 a943880373aecca8fa45db982d670606586f6c28a46b735db5271edc
+checkBatch 512224 17 7d85c439ce5beeeecadb7f17b19a60e37c594756e339f2bf8bbd4188
+checkBatch 512224 1100 f7be28feff6f5c2ae535a2c75758edb9f9b01d1632c9bf4cc09b68f3
+
+checkBatch 512256 1 3190a498affd17163396daaf839d069b1c14dcd271576ef26b20272863adeec6
+checkBatch 512256 17 0826daaaeef5d0a1c35a1ce34c951dfbc6eb04d6e7e9f783b1c73dad400ff8bc
+checkBatch 512256 1100 b00d8c79715f0cbe3de9ac7690c47b359727e85b5de698408b31fcc5c66addb2
+
+
+# computeHashAppended() after each append, 120 bytes (and 1000 bytes for
+# SHA-384 and SHA-512) need a second block for the padding
+checkAppend 1 0 da39a3ee5e6b4b0d3255bfef95601890afd80709
+checkAppend 1 120 d3dbd653bd8597b7475321b60a36891278e6a04a
+checkAppend 1 1000 c9c960a0b925474fab83942cc27d504fc24ac37b
+
+checkAppend 224 0 d14a028c2a3a2bc9476102bb288234c415a2b01f828ea62ac5b3e42f
+checkAppend 224 120 d022deb78772a77e8b91d68f90ca1f636e8fe047ae219434ced18eef
+checkAppend 224 1000 c182669a7f6629dc7fd8a9198f15af15adbbaeffa1842e854f681357
+
+checkAppend 256 0 e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855
+checkAppend 256 120 f52b23db1fbb6ded89ef42a23ce0c8922c45f25c50b568a93bf1c075420bbb7c
+checkAppend 256 1000 4e4c294b331f7a2099a379bec34b9f9fc03dc46ab465d998f4d683da53487e6d
+
+checkAppend 384 0 38b060a751ac96384cd9327eb1b1e36a21fdb71114be07434c0cc7bf63f6e1da274edebfe76f65fbd51ad2f14898b95b
+checkAppend 384 120 0577ad6090b2a39ffa1c4a25436f9e958890c55a5b23cf8cee8195a5984316d81d6cf0b5916c0ad8b1f512fb39826c6d
+checkAppend 384 1000 7a2f8c7f12344964a13cb9260492b845e56615d6152b9eb9e54b580fc88405e64f31813bfda10de2a642fdf1676c61b4
+
+checkAppend 512 0 cf83e1357eefb8bdf1542850d66d8007d620e4050b5715dc83f4a921d36ce9ce47d0d13c5d85f2b0ff8318d2877eec2f63b931bd47417a81a538327af927da3e
+checkAppend 512 120 9636708964c5ff6600510319e07bf3fcfcb1f4058fec278efb677964ba1e140c1632505452f802e99bcf09da3d456dc3868d149a0788a730e49d239ce7415145
+checkAppend 512 1000 5096498d96f50f9a137c4db5b8b0cd38383ad55350fb5a98805fedc31fa1262f1f0cf4d6f12d7ecd8dedd933a4c9126344fe22e937a8ad35fdeae1e876ae698b
+
+checkAppend 512224 0 6ed0dd02806fa89e25de060c19d3ac86cabb87d6a0ddd05c333b84f4
+checkAppend 512224 120 3055cc455c76a920206971189dade9a78a53e2455c12865c4ed36ce3
+checkAppend 512224 1000 c37d5044d175f42e9993f2e3a059e14980cd85b209681dd218aa8a6b
+
+checkAppend 512256 0 c672b8d1ef56ed28ab87c3622c5114069bdd3ad7b8f9737498d0c01ecef0967a
+checkAppend 512256 120 be74a90abbc2ea03ff56dedae4eda154ba6cf24d73a515903356283b653f5109
+checkAppend 512256 1000 974bc1ca87fcb8f487f65a650d1eeeebdc0cc269381b9eeb708cc4ea6d4954f2
+
+# fork() of streams and hashers, midstate() and resume
+checkFork 1 c9c960a0b925474fab83942cc27d504fc24ac37b
+checkFork 224 c182669a7f6629dc7fd8a9198f15af15adbbaeffa1842e854f681357
+checkFork 256 4e4c294b331f7a2099a379bec34b9f9fc03dc46ab465d998f4d683da53487e6d
+checkFork 384 7a2f8c7f12344964a13cb9260492b845e56615d6152b9eb9e54b580fc88405e64f31813bfda10de2a642fdf1676c61b4
+checkFork 512 5096498d96f50f9a137c4db5b8b0cd38383ad55350fb5a98805fedc31fa1262f1f0cf4d6f12d7ecd8dedd933a4c9126344fe22e937a8ad35fdeae1e876ae698b
+checkFork 512224 c37d5044d175f42e9993f2e3a059e14980cd85b209681dd218aa8a6b
+checkFork 512256 974bc1ca87fcb8f487f65a650d1eeeebdc0cc269381b9eeb708cc4ea6d4954f2
+
+echo
+if [ $FAIL_COUNT == 0 ]
+then
+    echo All tests passed
+else
+    echo "There were "$FAIL_COUNT" failures"
+fi
@@ -1,14 +1,13 @@
 #ifndef _CRYPTL_DIGEST_HPP_
 #define _CRYPTL_DIGEST_HPP_
 
-#include <climits>
 #include <cstdint>
 #include <functional>
 #include <istream>
-#include <sstream>
 #include <vector>
 
 #include <cryptl/Bless.hpp>
+#include <cryptl/SHA_Stream.hpp>
 
 namespace cryptl {
 
@@ -44,22 +43,21 @@ typename T::DigType digest(T hashAlgo, std::istream& is)
         });
 }
 
+// pads the byte string message
+// (words are loaded directly from memory, no stream or copy of the message)
+template <typename T>
+typename T::DigType digest(T hashAlgo, const std::uint8_t* p, const std::size_t n)
+{
+    SHA_Stream<T> hashStream(hashAlgo);
+    hashStream.update(p, n);
+    return hashStream.final();
+}
+
 // pads the byte vector message
 template <typename T>
 typename T::DigType digest(T hashAlgo, const std::vector<std::uint8_t>& a)
 {
-    std::stringstream ss;
-    for (const auto& b : a) ss.put(b);
-
-    std::size_t lengthBits = a.size() * CHAR_BIT;
-    T::padMessage(ss, lengthBits);
-
-    return digest(
-        hashAlgo,
-        ss,
-        [] (typename T::WordType& a, std::istream& is) {
-            return bless(a, is);
-        });
+    return digest(hashAlgo, a.data(), a.size());
 }
 
 } // namespace cryptl
@@ -0,0 +1,123 @@
+#ifndef _CRYPTL_DIGEST_BATCH_HPP_
+#define _CRYPTL_DIGEST_BATCH_HPP_
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include <cryptl/SHA_1.hpp>
+#include <cryptl/SHA_224.hpp>
+#include <cryptl/SHA_256.hpp>
+#include <cryptl/SHA_256_MultiBuffer.hpp>
+#include <cryptl/SHA_384.hpp>
+#include <cryptl/SHA_512.hpp>
+#include <cryptl/SHA_512_224.hpp>
+#include <cryptl/SHA_512_256.hpp>
+#include <cryptl/SHA_512_MultiBuffer.hpp>
+#include <cryptl/SHA_MultiBuffer.hpp>
+
+namespace cryptl {
+
+////////////////////////////////////////////////////////////////////////////////
+// message bytes in memory owned by someone else
+//
+
+class ByteSpan
+{
+public:
+    ByteSpan(const std::uint8_t* p, const std::size_t n)
+        : data(p),
+          size(n)
+    {}
+
+    ByteSpan(const std::vector<std::uint8_t>& a)
+        : data(a.data()),
+          size(a.size())
+    {}
+
+    const std::uint8_t* data;
+    std::size_t size;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// SIMD compression function for each hash algorithm
+//
+
+template <typename T> struct SHA_LanesOf { typedef SHA_NoLanes Type; };
+
+template <> struct SHA_LanesOf<SHA224> { typedef SHA_256_Lanes Type; };
+template <> struct SHA_LanesOf<SHA256> { typedef SHA_256_Lanes Type; };
+template <> struct SHA_LanesOf<SHA384> { typedef SHA_512_Lanes Type; };
+template <> struct SHA_LanesOf<SHA512> { typedef SHA_512_Lanes Type; };
+template <> struct SHA_LanesOf<SHA512_224> { typedef SHA_512_Lanes Type; };
+template <> struct SHA_LanesOf<SHA512_256> { typedef SHA_512_Lanes Type; };
+
+////////////////////////////////////////////////////////////////////////////////
+// message digests of a batch of byte strings
+//
+// Hashed in multi-buffer SIMD lanes, the state of all lanes is one array per
+// hash word (struct-of-arrays). A lane takes the next message as soon as its
+// message is done, so lanes are only idle at the end of each group. Within
+// a group the messages go in by block count, most blocks first, so the ones
+// left at the end are short. Digests are in the same order as the messages.
+//
+
+// the hash algorithm argument only selects the template
+template <typename T>
+void digest(T,
+            const ByteSpan* msg,
+            const std::size_t N,
+            typename T::DigType* out)
+{
+    typedef SHA_MultiBuffer<T, typename SHA_LanesOf<T>::Type> MultiBuffer;
+    typedef typename T::WordType WordType;
+
+    // messages per call to the multi-buffer engine, nothing is allocated
+    const std::size_t GROUP = 1024;
+
+    // padding is at least bit "1" and two words of length
+    const std::size_t BLOCK_BYTES = 16 * sizeof(WordType);
+    const std::size_t PAD_BYTES = 1 + 2 * sizeof(WordType);
+
+    std::array<std::size_t, GROUP> order, blocks;
+    std::array<const std::uint8_t*, GROUP> p;
+    std::array<std::size_t, GROUP> n;
+    std::array<typename T::DigType, GROUP> d;
+
+    for (std::size_t i = 0; i < N; i += GROUP) {
+        const std::size_t count = N - i < GROUP ? N - i : GROUP;
+
+        for (std::size_t k = 0; k < count; ++k) {
+            order[k] = k;
+            blocks[k] = (msg[i + k].size + PAD_BYTES + BLOCK_BYTES - 1) / BLOCK_BYTES;
+        }
+
+        std::sort(order.begin(),
+                  order.begin() + count,
+                  [&] (const std::size_t a, const std::size_t b) {
+                      return blocks[a] > blocks[b];
+                  });
+
+        for (std::size_t k = 0; k < count; ++k) {
+            p[k] = msg[i + order[k]].data;
+            n[k] = msg[i + order[k]].size;
+        }
+
+        MultiBuffer().digest(p.data(), n.data(), count, d.data());
+
+        for (std::size_t k = 0; k < count; ++k) out[i + order[k]] = d[k];
+    }
+}
+
+template <typename T>
+std::vector<typename T::DigType> digest(T hashAlgo, const std::vector<ByteSpan>& msg)
+{
+    std::vector<typename T::DigType> out(msg.size());
+    digest(hashAlgo, msg.data(), msg.size(), out.data());
+    return out;
+}
+
+} // namespace cryptl
+
+#endif
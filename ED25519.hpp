@@ -11,6 +11,7 @@
 #include <cryptl/ED25519_sc.hpp>
 #include <cryptl/NS_cryptl.hpp>
 #include <cryptl/SHA_512.hpp>
+#include <cryptl/SHA_512_MultiBuffer.hpp>
 
 namespace cryptl {
 
@@ -18,6 +19,44 @@ namespace cryptl {
 // direct translation of: supercop-20141124/crypto_sign/ed25519/ref/open.c
 // direct translation of: supercop-20141124/crypto_sign/ed25519/ref/sign.c
 
+////////////////////////////////////////////////////////////////////////////////
+// SHA-512 of many messages at once (only for unmanaged types)
+//
+
+template <typename U8, typename MSG, typename FUN>
+class ED_25519_Batch
+{
+public:
+    static bool available() { return false; }
+
+    static void sha512(std::vector<std::vector<U8>>&,
+                       const std::vector<std::vector<U8>>&) {
+    }
+};
+
+template <>
+class ED_25519_Batch<std::uint8_t,
+                     std::uint64_t,
+                     SHA_Functions<std::uint64_t,
+                                   std::uint64_t,
+                                   BitwiseINT<std::uint64_t>>>
+{
+public:
+    static bool available() { return true; }
+
+    static void sha512(std::vector<std::vector<std::uint8_t>>& out,
+                       const std::vector<std::vector<std::uint8_t>>& msg) {
+        const auto dig = SHA512_MultiBuffer().digest(msg);
+
+        // message digests as bytes
+        for (std::size_t i = 0; i < msg.size(); ++i) {
+            for (std::size_t j = 0; j < out[i].size(); ++j) {
+                out[i][j] = dig[i][j / 8] >> (56 - (j % 8) * 8);
+            }
+        }
+    }
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 // public and secret key pair
 //
@@ -106,12 +145,140 @@ public:
         scs.to32bytes(S);
     }
 
+    // sign many messages with the same key pair
+    // (all SHA-512 inputs of a step are hashed together)
+    static
+    void sign(std::vector<std::array<U8, 32>>& R,
+              std::vector<std::array<U8, 32>>& S,
+              const std::vector<std::vector<U8>>& m,
+              const std::array<U8, 32>& pk,
+              const std::array<U8, 32>& sk)
+    {
+        const std::size_t N = m.size();
+        R.resize(N);
+        S.resize(N);
+
+        std::array<U8, 64> az;
+        init_az(az, sk);
+        // az: 32-byte scalar a, 32-byte randomizer z
+
+        std::vector<std::vector<U8>> vnonce(N, std::vector<U8>(64)), vzm(N);
+        for (std::size_t i = 0; i < N; ++i) {
+            vzm[i].resize(32 + m[i].size());
+            for (std::size_t j = 0; j < 32; ++j) vzm[i][j] = az[j + 32];
+            for (std::size_t j = 0; j < m[i].size(); ++j) vzm[i][j + 32] = m[i][j];
+        }
+        // vzm: 32-byte randomizer z, message m
+
+        sha512(vnonce, vzm);
+        // vnonce: 64-byte H(z, m)
+
+        std::vector<SC> sck(N);
+        std::vector<std::vector<U8>> vhram(N, std::vector<U8>(64)), vRAm(N);
+        for (std::size_t i = 0; i < N; ++i) {
+            std::array<U8, 64> nonce;
+            for (std::size_t j = 0; j < 64; ++j) nonce[j] = vnonce[i][j];
+            sck[i].from64bytes(nonce);
+
+            GE ger;
+            ger.scalarmult_base(sck[i]);
+            ger.pack(R[i]);
+
+            vRAm[i].resize(64 + m[i].size());
+            for (std::size_t j = 0; j < 32; ++j) vRAm[i][j] = R[i][j];
+            for (std::size_t j = 0; j < 32; ++j) vRAm[i][j + 32] = pk[j];
+            for (std::size_t j = 0; j < m[i].size(); ++j) vRAm[i][j + 64] = m[i][j];
+        }
+        // vRAm: 32-byte R, 32-byte A, message m
+
+        sha512(vhram, vRAm);
+        // vhram: 64-byte H(R, A, m)
+
+        std::array<U8, 32> aza;
+        for (std::size_t j = 0; j < 32; ++j) aza[j] = az[j];
+        SC scsk;
+        scsk.from32bytes(aza);
+
+        for (std::size_t i = 0; i < N; ++i) {
+            std::array<U8, 64> hram;
+            for (std::size_t j = 0; j < 64; ++j) hram[j] = vhram[i][j];
+
+            SC scs;
+            scs.from64bytes(hram);
+            scs.mul(scs, scsk);
+            scs.add(scs, sck[i]);
+            // scs: S = nonce + H(R, A, m)a
+
+            scs.to32bytes(S[i]);
+        }
+    }
+
     // verify signature
     static
     B open(const std::array<U8, 32>& R,
            const std::array<U8, 32>& S,
            const std::vector<U8>& m,
            const std::array<U8, 32>& pk)
+    {
+        std::vector<U8> vhram(64), vm(64 + m.size());
+        for (std::size_t i = 0; i < 32; ++i) vm[i] = R[i];
+        for (std::size_t i = 0; i < 32; ++i) vm[i + 32] = pk[i];
+        for (std::size_t i = 0; i < m.size(); ++i) vm[i + 64] = m[i];
+        // vm: 32-byte R, 32-byte A, message m
+
+        sha512(vhram, vm);
+        std::array<U8, 64> hram;
+        for (std::size_t i = 0; i < 64; ++i) hram[i] = vhram[i];
+        // hram: 64-byte H(R, A, m)
+
+        return verify(R, S, hram, pk);
+    }
+
+    // verify many signatures
+    // (all H(R, A, m) are hashed together, every signature fails if R, S
+    // and pk are not the same length as m)
+    static
+    std::vector<B> open(const std::vector<std::array<U8, 32>>& R,
+                        const std::vector<std::array<U8, 32>>& S,
+                        const std::vector<std::vector<U8>>& m,
+                        const std::vector<std::array<U8, 32>>& pk)
+    {
+        const std::size_t N = m.size();
+
+        if (R.size() != N || S.size() != N || pk.size() != N)
+            return std::vector<B>(N, BIT8::testbit(BIT8::constant(0), 0));
+
+        std::vector<std::vector<U8>> vhram(N, std::vector<U8>(64)), vm(N);
+        for (std::size_t i = 0; i < N; ++i) {
+            vm[i].resize(64 + m[i].size());
+            for (std::size_t j = 0; j < 32; ++j) vm[i][j] = R[i][j];
+            for (std::size_t j = 0; j < 32; ++j) vm[i][j + 32] = pk[i][j];
+            for (std::size_t j = 0; j < m[i].size(); ++j) vm[i][j + 64] = m[i][j];
+        }
+        // vm: 32-byte R, 32-byte A, message m
+
+        sha512(vhram, vm);
+        // vhram: 64-byte H(R, A, m)
+
+        std::vector<B> ok;
+        ok.reserve(N);
+        for (std::size_t i = 0; i < N; ++i) {
+            std::array<U8, 64> hram;
+            for (std::size_t j = 0; j < 64; ++j) hram[j] = vhram[i][j];
+
+            ok.push_back(verify(R[i], S[i], hram, pk[i]));
+        }
+
+        return ok;
+    }
+
+private:
+    // verify signature given H(R, A, m)
+    static
+    B verify(const std::array<U8, 32>& R,
+             const std::array<U8, 32>& S,
+             const std::array<U8, 64>& hram,
+             const std::array<U8, 32>& pk)
     {
         GE get1;
         const B badsig =
@@ -126,17 +293,6 @@ public:
         SC scs;
         scs.from32bytes(S);
 
-        std::vector<U8> vhram(64), vm(64 + m.size());
-        for (std::size_t i = 0; i < 32; ++i) vm[i] = R[i];
-        for (std::size_t i = 0; i < 32; ++i) vm[i + 32] = pk[i];
-        for (std::size_t i = 0; i < m.size(); ++i) vm[i + 64] = m[i];
-        // vm: 32-byte R, 32-byte A, message m
-
-        sha512(vhram, vm);
-        std::array<U8, 64> hram;
-        for (std::size_t i = 0; i < 64; ++i) hram[i] = vhram[i];
-        // hram: 64-byte H(R, A, m)
-
         SC schram;
         schram.from64bytes(hram);
 
@@ -151,7 +307,20 @@ public:
             BIT32::logicalNOT(NS::notequal(R, rcheck)));
     }
 
-private:
+    // SHA-512 of many messages (multi-buffer when unmanaged)
+    static
+    void sha512(std::vector<std::vector<U8>>& out,
+                const std::vector<std::vector<U8>>& msg) {
+        typedef ED_25519_Batch<U8, MSG, FUN> Batch;
+
+        if (Batch::available()) {
+            Batch::sha512(out, msg);
+        } else {
+            for (std::size_t i = 0; i < msg.size(); ++i)
+                sha512(out[i], msg[i]);
+        }
+    }
+
     static
     void sha512(std::vector<U8>& out, const std::vector<U8>& msg) {
         const std::size_t
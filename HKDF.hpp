@@ -0,0 +1,130 @@
+#ifndef _CRYPTL_HKDF_HPP_
+#define _CRYPTL_HKDF_HPP_
+
+#include <array>
+#include <cstdint>
+
+#include <cryptl/Bless.hpp>
+#include <cryptl/HMAC.hpp>
+#include <cryptl/Wipe.hpp>
+
+namespace cryptl {
+
+////////////////////////////////////////////////////////////////////////////////
+// HMAC-based extract-and-expand key derivation (RFC 5869)
+//
+// T is: SHA1, SHA224, SHA256, SHA384, SHA512, SHA512_224, SHA512_256
+//
+// The HMAC pad midstates of the PRK are computed once when the object is
+// made, then shared by every expand() and every counter block. All buffers
+// are fixed size arrays, nothing is allocated. Intermediate keying material
+// is wiped before it goes out of scope.
+//
+
+template <typename T>
+class HKDF
+{
+public:
+    static const std::size_t HASH_BYTES = HMAC<T>::DIGEST_BYTES;
+
+    typedef std::array<std::uint8_t, HASH_BYTES> PRKType;
+
+    // HKDF-Extract (RFC 5869 section 2.2)
+    static PRKType extract(const std::uint8_t* salt,
+                           const std::size_t saltLen,
+                           const std::uint8_t* IKM,
+                           const std::size_t IKMLen)
+    {
+        // missing salt is HashLen zero bytes, same as HMAC key of nothing
+        HMAC<T> prf(salt, saltLen);
+        prf.update(IKM, IKMLen);
+
+        PRKType PRK;
+        storeBigEndian(PRK.data(), prf.final());
+        return PRK;
+    }
+
+    // from a pseudorandom key
+    HKDF(const std::uint8_t* PRK, const std::size_t PRKLen)
+        : m_prf(PRK, PRKLen)
+    {}
+
+    explicit HKDF(const PRKType& PRK)
+        : m_prf(PRK.data(), PRK.size())
+    {}
+
+    // extract then ready to expand
+    HKDF(const std::uint8_t* salt,
+         const std::size_t saltLen,
+         const std::uint8_t* IKM,
+         const std::size_t IKMLen)
+        : m_prf(salt, saltLen)
+    {
+        m_prf.update(IKM, IKMLen);
+
+        PRKType PRK;
+        storeBigEndian(PRK.data(), m_prf.final());
+        m_prf.setKey(PRK.data(), PRK.size());
+        wipe(PRK);
+    }
+
+    // HKDF-Expand (RFC 5869 section 2.3)
+    // returns false if L is more than 255 * HashLen
+    bool expand(std::uint8_t* OKM,
+                const std::size_t L,
+                const std::uint8_t* info,
+                const std::size_t infoLen)
+    {
+        if (L > 255 * HASH_BYTES) return false;
+
+        // T(0) is empty, T(i) = HMAC-Hash(PRK, T(i-1) | info | i)
+        std::array<std::uint8_t, HASH_BYTES> Ti;
+        std::size_t TiLen = 0;
+
+        std::uint8_t counter = 0;
+        for (std::size_t offset = 0; offset < L; offset += HASH_BYTES) {
+            ++counter;
+
+            m_prf.init();
+            m_prf.update(Ti.data(), TiLen);
+            m_prf.update(info, infoLen);
+            m_prf.update(&counter, 1);
+            storeBigEndian(Ti.data(), m_prf.final());
+            TiLen = HASH_BYTES;
+
+            for (std::size_t i = 0; i < HASH_BYTES && offset + i < L; ++i) {
+                OKM[offset + i] = Ti[i];
+            }
+        }
+
+        wipe(Ti);
+        return true;
+    }
+
+    // fixed length subkey
+    template <std::size_t L>
+    std::array<std::uint8_t, L> expand(const std::uint8_t* info,
+                                       const std::size_t infoLen)
+    {
+        static_assert(L <= 255 * HASH_BYTES, "HKDF output too long");
+
+        std::array<std::uint8_t, L> OKM;
+        expand(OKM.data(), L, info, infoLen);
+        return OKM;
+    }
+
+private:
+    HMAC<T> m_prf;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// typedefs
+//
+
+typedef HKDF<SHA256> HKDF_SHA256;
+
+typedef HKDF<SHA512> HKDF_SHA512;
+
+} // namespace cryptl
+
+#endif
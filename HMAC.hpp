@@ -0,0 +1,169 @@
+#ifndef _CRYPTL_HMAC_HPP_
+#define _CRYPTL_HMAC_HPP_
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include <cryptl/Bless.hpp>
+#include <cryptl/Digest.hpp>
+#include <cryptl/SHA_1.hpp>
+#include <cryptl/SHA_224.hpp>
+#include <cryptl/SHA_256.hpp>
+#include <cryptl/SHA_384.hpp>
+#include <cryptl/SHA_512.hpp>
+#include <cryptl/SHA_512_224.hpp>
+#include <cryptl/SHA_512_256.hpp>
+#include <cryptl/SHA_Stream.hpp>
+#include <cryptl/Wipe.hpp>
+
+namespace cryptl {
+
+////////////////////////////////////////////////////////////////////////////////
+// keyed-hash message authentication code (FIPS 198-1, RFC 2104)
+//
+// T is: SHA1, SHA224, SHA256, SHA384, SHA512, SHA512_224, SHA512_256
+//
+// The key XOR ipad and key XOR opad blocks are compressed once when the key
+// is set and kept as midstates. Each message then costs its own blocks and
+// one outer block. The midstates are as good as the key. They, the inner
+// hash in progress and every temporary hash state are wiped (SHA_Stream
+// wipes itself when destroyed).
+//
+
+template <typename T>
+class HMAC
+{
+public:
+    typedef typename T::WordType WordType;
+    typedef typename T::DigType DigType;
+    typedef typename T::MidType MidType;
+
+    static const std::size_t BLOCK_BYTES = 16 * sizeof(WordType);
+    static const std::size_t DIGEST_BYTES =
+        std::tuple_size<DigType>::value * sizeof(typename DigType::value_type);
+
+    HMAC(const std::uint8_t* key, const std::size_t n) {
+        setKey(key, n);
+    }
+
+    explicit HMAC(const std::vector<std::uint8_t>& key) {
+        setKey(key.data(), key.size());
+    }
+
+    ~HMAC() {
+        wipe(m_inner);
+        wipe(m_outer);
+        m_stream.wipeHash();
+    }
+
+    void setKey(const std::uint8_t* key, const std::size_t n) {
+        // K0 (FIPS 198-1 section 4)
+        std::array<std::uint8_t, BLOCK_BYTES> block;
+        block.fill(0);
+
+        if (n > BLOCK_BYTES) {
+            storeBigEndian(block.data(), digest(T(), key, n));
+        } else {
+            for (std::size_t i = 0; i < n; ++i) block[i] = key[i];
+        }
+
+        for (auto& b : block) b ^= 0x36;
+        SHA_Stream<T> inner;
+        inner.update(block.data(), BLOCK_BYTES);
+        m_inner = inner.midstate();
+
+        for (auto& b : block) b ^= 0x36 ^ 0x5c;
+        SHA_Stream<T> outer;
+        outer.update(block.data(), BLOCK_BYTES);
+        m_outer = outer.midstate();
+
+        wipe(block);
+        init();
+    }
+
+    // incremental: init(), update() pieces of message, final()
+    void init() {
+        m_stream.init(m_inner);
+    }
+
+    void update(const std::uint8_t* p, const std::size_t n) {
+        m_stream.update(p, n);
+    }
+
+    void update(const std::vector<std::uint8_t>& a) {
+        m_stream.update(a);
+    }
+
+    // must be initialized again before reuse
+    DigType final() {
+        auto innerDigest = m_stream.final();
+        m_stream.wipeHash();
+
+        const auto d = outerHash(innerDigest);
+        wipe(innerDigest);
+        return d;
+    }
+
+    // authentication code of entire message
+    DigType mac(const std::uint8_t* p, const std::size_t n) const {
+        SHA_Stream<T> inner(m_inner);
+        inner.update(p, n);
+
+        auto innerDigest = inner.final();
+        const auto d = outerHash(innerDigest);
+        wipe(innerDigest);
+        return d;
+    }
+
+    DigType mac(const std::vector<std::uint8_t>& a) const {
+        return mac(a.data(), a.size());
+    }
+
+    // compressed key XOR ipad and key XOR opad blocks
+    const MidType& innerMidstate() const {
+        return m_inner;
+    }
+
+    const MidType& outerMidstate() const {
+        return m_outer;
+    }
+
+private:
+    DigType outerHash(const DigType& innerDigest) const {
+        std::array<std::uint8_t, DIGEST_BYTES> b;
+        storeBigEndian(b.data(), innerDigest);
+
+        SHA_Stream<T> outer(m_outer);
+        outer.update(b.data(), DIGEST_BYTES);
+        wipe(b);
+        return outer.final();
+    }
+
+    // key XOR ipad, key XOR opad
+    MidType m_inner, m_outer;
+
+    SHA_Stream<T> m_stream;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// typedefs
+//
+
+typedef HMAC<SHA1> HMAC_SHA1;
+
+typedef HMAC<SHA224> HMAC_SHA224;
+
+typedef HMAC<SHA256> HMAC_SHA256;
+
+typedef HMAC<SHA384> HMAC_SHA384;
+
+typedef HMAC<SHA512> HMAC_SHA512;
+
+typedef HMAC<SHA512_224> HMAC_SHA512_224;
+
+typedef HMAC<SHA512_256> HMAC_SHA512_256;
+
+} // namespace cryptl
+
+#endif
@@ -0,0 +1,269 @@
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "cryptl/ASCII_Hex.hpp"
+#include "cryptl/Bless.hpp"
+#include "cryptl/HKDF.hpp"
+#include "cryptl/HMAC.hpp"
+#include "cryptl/PBKDF2.hpp"
+
+using namespace cryptl;
+using namespace std;
+
+void printUsage(const char* exeName) {
+    const string
+        A = " -a 1|224|256|384|512|512224|512256",
+        K = " -k key_in_hex",
+        M = " -m message_in_hex",
+        L = " [-l output_bytes]",
+        P = " -p password_in_hex",
+        S = " -s salt_in_hex",
+        C = " -c iterations",
+        DL = " -l output_bytes",
+        N = " [-n batch_size]",
+        I = " -i input_key_in_hex",
+        HS = " [-s salt_in_hex]",
+        F = " [-f info_in_hex]";
+
+    cerr << "HMAC:   " << exeName << A << K << M << L << endl;
+    cerr << "PBKDF2: " << exeName << A << P << S << C << DL << N << endl;
+    cerr << "HKDF:   " << exeName << A << I << HS << F << DL << endl;
+
+    exit(EXIT_FAILURE);
+}
+
+// bytes as hexadecimal text, truncated to len if not zero
+string hexBytes(const vector<uint8_t>& v, const size_t len) {
+    return asciiHex(0 == len || len > v.size()
+                        ? v
+                        : vector<uint8_t>(v.begin(), v.begin() + len));
+}
+
+// HMAC of whole message and one byte at a time must agree
+template <typename T>
+void runHMAC(const vector<uint8_t>& key, const vector<uint8_t>& msg, const size_t len)
+{
+    HMAC<T> hmac(key);
+
+    const auto a = hmac.mac(msg);
+
+    hmac.init();
+    for (const auto& c : msg) hmac.update(&c, 1);
+    const auto b = hmac.final();
+
+    if (a != b) {
+        cout << "MAC: incremental mismatch" << endl;
+        return;
+    }
+
+    vector<uint8_t> v(HMAC<T>::DIGEST_BYTES);
+    storeBigEndian(v.data(), a);
+
+    cout << "MAC: " << hexBytes(v, len) << endl;
+}
+
+// PBKDF2 of a batch of passwords, each the same as derived on its own
+//
+// The first password is the one given, the others have a counter byte
+// appended. The batch runs in SIMD lanes when it is large enough, the
+// single derivations do not.
+template <typename T, typename LANES>
+void runPBKDF2(const vector<uint8_t>& password,
+               const vector<uint8_t>& salt,
+               const size_t c,
+               const size_t len,
+               const size_t batch)
+{
+    const PBKDF2<T, LANES> kdf;
+
+    vector<vector<uint8_t>> P(batch, password), S(batch, salt);
+    for (size_t k = 1; k < batch; ++k) P[k].push_back(k);
+
+    const auto dk = kdf.derive(P, S, c, len);
+
+    for (size_t k = 0; k < batch; ++k) {
+        if (dk[k] != kdf.derive(P[k], S[k], c, len)) {
+            cout << "DK: batch mismatch" << endl;
+            return;
+        }
+    }
+
+    cout << "DK: " << asciiHex(dk[0]) << endl;
+}
+
+// HKDF extract and expand, then the same from the pseudorandom key
+template <typename T>
+void runHKDF(const vector<uint8_t>& IKM,
+             const vector<uint8_t>& salt,
+             const vector<uint8_t>& info,
+             const size_t len)
+{
+    const auto PRK = HKDF<T>::extract(salt.data(), salt.size(), IKM.data(), IKM.size());
+
+    HKDF<T> a(salt.data(), salt.size(), IKM.data(), IKM.size());
+    HKDF<T> b(PRK);
+
+    vector<uint8_t> OKM(len), OKM2(len);
+    if (!a.expand(OKM.data(), len, info.data(), info.size()) ||
+        !b.expand(OKM2.data(), len, info.data(), info.size())) {
+        cout << "OKM: output too long" << endl;
+        return;
+    }
+
+    if (OKM != OKM2) {
+        cout << "OKM: extract mismatch" << endl;
+        return;
+    }
+
+    cout << "PRK: " << asciiHex(vector<uint8_t>(PRK.begin(), PRK.end())) << endl
+         << "OKM: " << asciiHex(OKM) << endl;
+}
+
+int main(int argc, char *argv[])
+{
+    size_t shaBits = 0, len = 0, iterations = 0, batch = 1;
+    vector<uint8_t> key, msg, password, salt, IKM, info;
+    bool bk = false, bm = false, bp = false, bs = false, bi = false;
+    int opt;
+    while (-1 != (opt = getopt(argc, argv, "a:k:m:l:p:s:c:n:i:f:"))) {
+        switch (opt) {
+
+        case ('a') : // algorithm
+            {
+                stringstream ss(optarg);
+                if (!(ss >> shaBits)) {
+                    cerr << "error: algorithm " << optarg << endl;
+                    exit(EXIT_FAILURE);
+                }
+            }
+            break;
+
+        case ('k') : // key
+            if (!asciiHexToVector(optarg, key)) {
+                cerr << "error: key in hex: " << optarg << endl;
+                exit(EXIT_FAILURE);
+            }
+            bk = true;
+            break;
+
+        case ('m') : // message
+            if (!asciiHexToVector(optarg, msg)) {
+                cerr << "error: message in hex: " << optarg << endl;
+                exit(EXIT_FAILURE);
+            }
+            bm = true;
+            break;
+
+        case ('l') : // output bytes
+            {
+                stringstream ss(optarg);
+                if (!(ss >> len)) {
+                    cerr << "error: output bytes " << optarg << endl;
+                    exit(EXIT_FAILURE);
+                }
+            }
+            break;
+
+        case ('p') : // password
+            if (!asciiHexToVector(optarg, password)) {
+                cerr << "error: password in hex: " << optarg << endl;
+                exit(EXIT_FAILURE);
+            }
+            bp = true;
+            break;
+
+        case ('s') : // salt
+            if (!asciiHexToVector(optarg, salt)) {
+                cerr << "error: salt in hex: " << optarg << endl;
+                exit(EXIT_FAILURE);
+            }
+            bs = true;
+            break;
+
+        case ('c') : // iterations
+            {
+                stringstream ss(optarg);
+                if (!(ss >> iterations) || 0 == iterations) {
+                    cerr << "error: iterations " << optarg << endl;
+                    exit(EXIT_FAILURE);
+                }
+            }
+            break;
+
+        case ('n') : // batch size
+            {
+                stringstream ss(optarg);
+                if (!(ss >> batch) || 0 == batch || batch > 255) {
+                    cerr << "error: batch size " << optarg << endl;
+                    exit(EXIT_FAILURE);
+                }
+            }
+            break;
+
+        case ('i') : // input keying material
+            if (!asciiHexToVector(optarg, IKM)) {
+                cerr << "error: input key in hex: " << optarg << endl;
+                exit(EXIT_FAILURE);
+            }
+            bi = true;
+            break;
+
+        case ('f') : // info
+            if (!asciiHexToVector(optarg, info)) {
+                cerr << "error: info in hex: " << optarg << endl;
+                exit(EXIT_FAILURE);
+            }
+            break;
+
+        default :
+            printUsage(argv[0]);
+        }
+    }
+
+    if (bk && bm) {
+        switch (shaBits) {
+        case (1) : runHMAC<SHA1>(key, msg, len); return EXIT_SUCCESS;
+        case (224) : runHMAC<SHA224>(key, msg, len); return EXIT_SUCCESS;
+        case (256) : runHMAC<SHA256>(key, msg, len); return EXIT_SUCCESS;
+        case (384) : runHMAC<SHA384>(key, msg, len); return EXIT_SUCCESS;
+        case (512) : runHMAC<SHA512>(key, msg, len); return EXIT_SUCCESS;
+        case (512224) : runHMAC<SHA512_224>(key, msg, len); return EXIT_SUCCESS;
+        case (512256) : runHMAC<SHA512_256>(key, msg, len); return EXIT_SUCCESS;
+        }
+
+    } else if (bp && bs && 0 != iterations && 0 != len) {
+        switch (shaBits) {
+        case (1) :
+            runPBKDF2<SHA1, SHA_NoLanes>(password, salt, iterations, len, batch);
+            return EXIT_SUCCESS;
+        case (224) :
+            runPBKDF2<SHA224, SHA_256_Lanes>(password, salt, iterations, len, batch);
+            return EXIT_SUCCESS;
+        case (256) :
+            runPBKDF2<SHA256, SHA_256_Lanes>(password, salt, iterations, len, batch);
+            return EXIT_SUCCESS;
+        case (384) :
+            runPBKDF2<SHA384, SHA_512_Lanes>(password, salt, iterations, len, batch);
+            return EXIT_SUCCESS;
+        case (512) :
+            runPBKDF2<SHA512, SHA_512_Lanes>(password, salt, iterations, len, batch);
+            return EXIT_SUCCESS;
+        }
+
+    } else if (bi && 0 != len) {
+        switch (shaBits) {
+        case (1) : runHKDF<SHA1>(IKM, salt, info, len); return EXIT_SUCCESS;
+        case (224) : runHKDF<SHA224>(IKM, salt, info, len); return EXIT_SUCCESS;
+        case (256) : runHKDF<SHA256>(IKM, salt, info, len); return EXIT_SUCCESS;
+        case (384) : runHKDF<SHA384>(IKM, salt, info, len); return EXIT_SUCCESS;
+        case (512) : runHKDF<SHA512>(IKM, salt, info, len); return EXIT_SUCCESS;
+        }
+    }
+
+    printUsage(argv[0]);
+}
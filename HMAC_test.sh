@@ -0,0 +1,159 @@
+#!/bin/bash
+
+# published test vectors:
+#   RFC 2202 HMAC-SHA-1
+#   RFC 4231 HMAC-SHA-224, HMAC-SHA-256, HMAC-SHA-384, HMAC-SHA-512
+#   RFC 5869 HKDF-SHA-1, HKDF-SHA-256
+#   RFC 6070 PBKDF2-HMAC-SHA-1
+#   RFC 7914 PBKDF2-HMAC-SHA-256
+
+FAIL_COUNT=0
+
+# text as hexadecimal octets
+hex() {
+    echo -n "$1" | od -An -v -tx1 | tr -d ' \n'
+}
+
+# octet in hex repeated N times
+rep() {
+    printf "$1%.0s" `seq 1 $2`
+}
+
+# checkHMAC bits key message expected_MAC (may be truncated)
+checkHMAC() {
+    MAC=`./HMAC_test -a $1 -k "$2" -m "$3" -l $((${#4} / 2)) | awk '{print $2}'`
+    if [ "$MAC" == "$4" ]
+    then
+        echo "OK HMAC-SHA"$1" "$4
+    else
+        echo "FAIL HMAC-SHA"$1" "$4
+        FAIL_COUNT=`expr $FAIL_COUNT + 1`
+    fi
+}
+
+# checkPBKDF2 bits password salt iterations expected_DK
+#
+# Each is also derived in a batch of 17 passwords, enough to fill the SIMD
+# lanes with a remainder.
+checkPBKDF2() {
+    for N in 1 17
+    do
+        DK=`./HMAC_test -a $1 -p "$2" -s "$3" -c $4 -l $((${#5} / 2)) -n $N | awk '{print $2}'`
+        if [ "$DK" == "$5" ]
+        then
+            echo "OK PBKDF2-SHA"$1" x"$N" "$5
+        else
+            echo "FAIL PBKDF2-SHA"$1" x"$N" "$5
+            FAIL_COUNT=`expr $FAIL_COUNT + 1`
+        fi
+    done
+}
+
+# checkHKDF bits IKM salt info expected_PRK expected_OKM
+checkHKDF() {
+    OUT=`./HMAC_test -a $1 -i "$2" -s "$3" -f "$4" -l $((${#6} / 2))`
+    PRK=`echo "$OUT" | awk '/^PRK:/ {print $2}'`
+    OKM=`echo "$OUT" | awk '/^OKM:/ {print $2}'`
+    if [ "$PRK" == "$5" -a "$OKM" == "$6" ]
+    then
+        echo "OK HKDF-SHA"$1" "$6
+    else
+        echo "FAIL HKDF-SHA"$1" "$6
+        FAIL_COUNT=`expr $FAIL_COUNT + 1`
+    fi
+}
+
+KEY4=0102030405060708090a0b0c0d0e0f10111213141516171819
+
+MSG1=`hex "Hi There"`
+MSG2=`hex "what do ya want for nothing?"`
+MSG5=`hex "Test With Truncation"`
+MSG6=`hex "Test Using Larger Than Block-Size Key - Hash Key First"`
+
+# RFC 2202 section 3
+MSG7=`hex "Test Using Larger Than Block-Size Key and Larger Than One Block-Size Data"`
+
+checkHMAC 1 `rep 0b 20` $MSG1 b617318655057264e28bc0b6fb378c8ef146be00
+checkHMAC 1 `hex Jefe` $MSG2 effcdf6ae5eb2fa2d27416d5f184df9c259a7c79
+checkHMAC 1 `rep aa 20` `rep dd 50` 125d7342b9ac11cd91a39af48aa17b4f63f175d3
+checkHMAC 1 $KEY4 `rep cd 50` 4c9007f4026250c6bc8414f9bf50c86c2d7235da
+checkHMAC 1 `rep 0c 20` $MSG5 4c1a03424b55e07fe7f27be1
+checkHMAC 1 `rep aa 80` $MSG6 aa4ae5e15272d00e95705637ce8a3b55ed402112
+checkHMAC 1 `rep aa 80` $MSG7 e8e99d0f45237d786d6bbaa7965c7808bbff1a91
+
+# RFC 4231 section 4
+MSG7=`hex "This is a test using a larger than block-size key and a larger than block-size data. The key needs to be hashed before being used by the HMAC algorithm."`
+
+checkHMAC 224 `rep 0b 20` $MSG1 896fb1128abbdf196832107cd49df33f47b4b1169912ba4f53684b22
+checkHMAC 224 `hex Jefe` $MSG2 a30e01098bc6dbbf45690f3a7e9e6d0f8bbea2a39e6148008fd05e44
+checkHMAC 224 `rep aa 20` `rep dd 50` 7fb3cb3588c6c1f6ffa9694d7d6ad2649365b0c1f65d69d1ec8333ea
+checkHMAC 224 $KEY4 `rep cd 50` 6c11506874013cac6a2abc1bb382627cec6a90d86efc012de7afec5a
+checkHMAC 224 `rep 0c 20` $MSG5 0e2aea68a90c8d37c988bcdb9fca6fa8
+checkHMAC 224 `rep aa 131` $MSG6 95e9a0db962095adaebe9b2d6f0dbce2d499f112f2d2b7273fa6870e
+checkHMAC 224 `rep aa 131` $MSG7 3a854166ac5d9f023f54d517d0b39dbd946770db9c2b95c9f6f565d1
+
+checkHMAC 256 `rep 0b 20` $MSG1 b0344c61d8db38535ca8afceaf0bf12b881dc200c9833da726e9376c2e32cff7
+checkHMAC 256 `hex Jefe` $MSG2 5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843
+checkHMAC 256 `rep aa 20` `rep dd 50` 773ea91e36800e46854db8ebd09181a72959098b3ef8c122d9635514ced565fe
+checkHMAC 256 $KEY4 `rep cd 50` 82558a389a443c0ea4cc819899f2083a85f0faa3e578f8077a2e3ff46729665b
+checkHMAC 256 `rep 0c 20` $MSG5 a3b6167473100ee06e0c796c2955552b
+checkHMAC 256 `rep aa 131` $MSG6 60e431591ee0b67f0d8a26aacbf5b77f8e0bc6213728c5140546040f0ee37f54
+checkHMAC 256 `rep aa 131` $MSG7 9b09ffa71b942fcb27635fbcd5b0e944bfdc63644f0713938a7f51535c3a35e2
+
+checkHMAC 384 `rep 0b 20` $MSG1 afd03944d84895626b0825f4ab46907f15f9dadbe4101ec682aa034c7cebc59cfaea9ea9076ede7f4af152e8b2fa9cb6
+checkHMAC 384 `hex Jefe` $MSG2 af45d2e376484031617f78d2b58a6b1b9c7ef464f5a01b47e42ec3736322445e8e2240ca5e69e2c78b3239ecfab21649
+checkHMAC 384 `rep aa 20` `rep dd 50` 88062608d3e6ad8a0aa2ace014c8a86f0aa635d947ac9febe83ef4e55966144b2a5ab39dc13814b94e3ab6e101a34f27
+checkHMAC 384 $KEY4 `rep cd 50` 3e8a69b7783c25851933ab6290af6ca77a9981480850009cc5577c6e1f573b4e6801dd23c4a7d679ccf8a386c674cffb
+checkHMAC 384 `rep 0c 20` $MSG5 3abf34c3503b2a23a46efc619baef897
+checkHMAC 384 `rep aa 131` $MSG6 4ece084485813e9088d2c63a041bc5b44f9ef1012a2b588f3cd11f05033ac4c60c2ef6ab4030fe8296248df163f44952
+checkHMAC 384 `rep aa 131` $MSG7 6617178e941f020d351e2f254e8fd32c602420feb0b8fb9adccebb82461e99c5a678cc31e799176d3860e6110c46523e
+
+checkHMAC 512 `rep 0b 20` $MSG1 87aa7cdea5ef619d4ff0b4241a1d6cb02379f4e2ce4ec2787ad0b30545e17cdedaa833b7d6b8a702038b274eaea3f4e4be9d914eeb61f1702e696c203a126854
+checkHMAC 512 `hex Jefe` $MSG2 164b7a7bfcf819e2e395fbe73b56e0a387bd64222e831fd610270cd7ea2505549758bf75c05a994a6d034f65f8f0e6fdcaeab1a34d4a6b4b636e070a38bce737
+checkHMAC 512 `rep aa 20` `rep dd 50` fa73b0089d56a284efb0f0756c890be9b1b5dbdd8ee81a3655f83e33b2279d39bf3e848279a722c806b485a47e67c807b946a337bee8942674278859e13292fb
+checkHMAC 512 $KEY4 `rep cd 50` b0ba465637458c6990e5a8c5f61d4af7e576d97ff94b872de76f8050361ee3dba91ca5c11aa25eb4d679275cc5788063a5f19741120c4f2de2adebeb10a298dd
+checkHMAC 512 `rep 0c 20` $MSG5 415fad6271580a531d4179bc891d87a6
+checkHMAC 512 `rep aa 131` $MSG6 80b24263c7c1a3ebb71493c1dd7be8b49b46d1f41b4aeec1121b013783f8f3526b56d037e05f2598bd0fd2215d6a1e5295e64f73f63f0aec8b915a985d786598
+checkHMAC 512 `rep aa 131` $MSG7 e37b6a775dc87dbaa4dfa9f96e5e3ffddebd71f8867289865df5a32d20cdc944b6022cac3c4982b10d5eeb55c3e4de15134676fb6de0446065c97440fa8c6a58
+
+# RFC 5869 appendix A (absent salt and info are empty)
+SALT1=000102030405060708090a0b0c
+INFO1=f0f1f2f3f4f5f6f7f8f9
+IKM2=`for i in \`seq 0 79\`; do printf "%02x" $i; done`
+SALT2=`for i in \`seq 96 175\`; do printf "%02x" $i; done`
+INFO2=`for i in \`seq 176 255\`; do printf "%02x" $i; done`
+
+checkHKDF 256 `rep 0b 22` $SALT1 $INFO1 077709362c2e32df0ddc3f0dc47bba6390b6c73bb50f9c3122ec844ad7c2b3e5 3cb25f25faacd57a90434f64d0362f2a2d2d0a90cf1a5a4c5db02d56ecc4c5bf34007208d5b887185865
+checkHKDF 256 $IKM2 $SALT2 $INFO2 06a6b88c5853361a06104c9ceb35b45cef760014904671014a193f40c15fc244 b11e398dc80327a1c8e7f78c596a49344f012eda2d4efad8a050cc4c19afa97c59045a99cac7827271cb41c65e590e09da3275600c2f09b8367793a9aca3db71cc30c58179ec3e87c14c01d5c1f3434f1d87
+checkHKDF 256 `rep 0b 22` "" "" 19ef24a32c717b167f33a91d6f648bdf96596776afdb6377ac434c1c293ccb04 8da4e775a563c18f715f802a063c5a31b8a11f5c5ee1879ec3454e5f3c738d2d9d201395faa4b61a96c8
+checkHKDF 1 `rep 0b 11` $SALT1 $INFO1 9b6c18c432a7bf8f0e71c8eb88f4b30baa2ba243 085a01ea1b10f36933068b56efa5ad81a4f14b822f5b091568a9cdd4f155fda2c22e422478d305f3f896
+checkHKDF 1 $IKM2 $SALT2 $INFO2 8adae09a2a307059478d309b26c4115a224cfaf6 0bd770a74d1160f7c9f12cd5912a06ebff6adcae899d92191fe4305673ba2ffe8fa3f1a4e5ad79f3f334b3b202b2173c486ea37ce3d397ed034c7f9dfeb15c5e927336d0441f4c4300e2cff0d0900b52d3b4
+checkHKDF 1 `rep 0b 22` "" "" da8c8a73c7fa77288ec6f5e7c297786aa0d32d01 0ac1af7002b3d761d1e55298da9d0506b9ae52057220a306e07b6b87e8df21d0ea00033de03984d34918
+checkHKDF 1 `rep 0c 22` "" "" 2adccada18779e7c2077ad2eb19d3f3e731385dd 2c91117204d745f3500d636a62f64f0ab3bae548aa53d423b0d1f27ebba6f5e5673a081d70cce7acfc48
+
+# RFC 6070 section 2 (the 16777216 iteration case is left out)
+PW=`hex password`
+SALT=`hex salt`
+
+checkPBKDF2 1 $PW $SALT 1 0c60c80f961f0e71f3a9b524af6012062fe037a6
+checkPBKDF2 1 $PW $SALT 2 ea6c014dc72d6f8ccd1ed92ace1d41f0d8de8957
+checkPBKDF2 1 $PW $SALT 4096 4b007901b765489abead49d926f721d065a429c1
+checkPBKDF2 1 `hex passwordPASSWORDpassword` `hex saltSALTsaltSALTsaltSALTsaltSALTsalt` 4096 3d2eec4fe41c849b80c8d83662c0e44a8b291a964cf2f07038
+checkPBKDF2 1 7061737300776f7264 7361006c74 4096 56fa6aa75548099dcc37d7f03425e0c3
+
+# RFC 7914 section 11
+checkPBKDF2 256 `hex passwd` $SALT 1 55ac046e56e3089fec1691c22544b605f94185216dde0465e68b9d57c20dacbc49ca9cccf179b645991664b39d77ef317c71b845b1e30bd509112041d3a19783
+checkPBKDF2 256 `hex Password` `hex NaCl` 80000 4ddcd8f60b98be21830cee5ef22701f9641a4418d04c0414aeff08876b34ab56a1d425a1225833549adb841b51c9b3176a272bdebba1d078478f62b397f33c8d
+
+# not published, computed with Python hashlib.pbkdf2_hmac
+checkPBKDF2 224 $PW $SALT 4096 218c453bf90635bd0a21a75d172703ff6108ef603f65bb821aedade1d6961683ba8f67877d2a3f73
+checkPBKDF2 384 $PW $SALT 4096 559726be38db125bc85ed7895f6e3cf574c7a01c080c3447db1e8a76764deb3c307b94853fbe424f6488c5f4f12896261d1eb430353c769ee2a77a26fd0a2347
+checkPBKDF2 512 $PW $SALT 4096 d197b1b33db0143e018b12f3d1d1479e6cdebdcc97c5c0f87f6902e072f457b5143f30602641b3d55cd335988cb36b84376060ecd532e039b742a239434af2d5d6883f0be4c24d363b638f4c2f8d917533cd4158937d0b490697a64adadb07f180c32308
+
+echo
+if [ $FAIL_COUNT == 0 ]
+then
+    echo All tests passed
+else
+    echo "There were "$FAIL_COUNT" failures"
+fi
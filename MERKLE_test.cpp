@@ -0,0 +1,187 @@
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "cryptl/ASCII_Hex.hpp"
+#include "cryptl/Bless.hpp"
+#include "cryptl/MerkleIncremental.hpp"
+#include "cryptl/MerkleTree.hpp"
+#include "cryptl/SHA_1.hpp"
+#include "cryptl/SHA_256.hpp"
+
+using namespace cryptl;
+using namespace std;
+
+void printUsage(const char* exeName) {
+    const string
+        A = " -a 1|256",
+        T = " -t chunk_bytes",
+        M = " -m message_in_hex",
+        U = " [-u leaf_index -v chunk_in_hex]";
+
+    cerr << exeName << A << T << M << U << endl;
+
+    exit(EXIT_FAILURE);
+}
+
+template <typename T>
+string hexDigest(const typename T::DigType& d) {
+    vector<uint8_t> v(MerkleTree<T>::DIGEST_BYTES);
+    storeBigEndian(v.data(), d);
+    return asciiHex(v);
+}
+
+// every leaf has a proof that verifies, and fails for a different leaf
+template <typename T>
+bool checkProofs(const MerkleIncremental<T>& tree)
+{
+    for (size_t i = 0; i < tree.size(); ++i) {
+        const auto path = tree.proof(i);
+
+        if (!MerkleIncremental<T>::verify(tree.root(), tree.leaf(i), i, tree.size(), path))
+            return false;
+
+        auto wrong = tree.leaf(i);
+        wrong[0] ^= 1;
+
+        if (MerkleIncremental<T>::verify(tree.root(), wrong, i, tree.size(), path))
+            return false;
+    }
+
+    return true;
+}
+
+// Root of the message from MerkleTree, and from MerkleIncremental built all
+// at once and one leaf at a time, must agree. Then one leaf is changed and
+// the updated tree must agree with one built from scratch.
+template <typename T>
+void runMerkle(const size_t chunkBytes,
+               const vector<uint8_t>& msg,
+               const bool update,
+               const size_t index,
+               const vector<uint8_t>& chunk)
+{
+    const MerkleTree<T> tree(chunkBytes, 1);
+
+    vector<typename T::DigType> leaves(tree.leafCount(msg.size()));
+    for (size_t i = 0; i < leaves.size(); ++i) {
+        const size_t offset = i * chunkBytes;
+        const size_t len = min(chunkBytes, msg.size() - offset);
+        leaves[i] = MerkleTree<T>::leafHash(msg.data() + offset, len);
+    }
+
+    MerkleIncremental<T> a(leaves), b;
+    for (const auto& d : leaves) b.append(d);
+
+    const auto root = tree.digest(msg.data(), msg.size());
+    if (a.root() != root || b.root() != root) {
+        cout << "ROOT: incremental mismatch" << endl;
+        return;
+    }
+
+    if (!checkProofs(a)) {
+        cout << "ROOT: proof failed" << endl;
+        return;
+    }
+
+    cout << "ROOT: " << hexDigest<T>(root) << endl;
+
+    if (!update) return;
+
+    if (index >= leaves.size()) {
+        cout << "UPDATE: no such leaf" << endl;
+        return;
+    }
+
+    a.update(index, chunk.data(), chunk.size());
+
+    leaves[index] = MerkleTree<T>::leafHash(chunk.data(), chunk.size());
+    const MerkleIncremental<T> c(leaves);
+
+    if (a.root() != c.root()) {
+        cout << "UPDATE: rebuild mismatch" << endl;
+        return;
+    }
+
+    if (!checkProofs(a)) {
+        cout << "UPDATE: proof failed" << endl;
+        return;
+    }
+
+    cout << "UPDATE: " << hexDigest<T>(a.root()) << endl;
+}
+
+int main(int argc, char *argv[])
+{
+    size_t shaBits = 0, chunkBytes = 0, index = 0;
+    vector<uint8_t> msg, chunk;
+    bool bm = false, bu = false, bv = false;
+    int opt;
+    while (-1 != (opt = getopt(argc, argv, "a:t:m:u:v:"))) {
+        switch (opt) {
+
+        case ('a') : // algorithm
+            {
+                stringstream ss(optarg);
+                if (!(ss >> shaBits)) {
+                    cerr << "error: algorithm " << optarg << endl;
+                    exit(EXIT_FAILURE);
+                }
+            }
+            break;
+
+        case ('t') : // chunk bytes
+            {
+                stringstream ss(optarg);
+                if (!(ss >> chunkBytes) || 0 == chunkBytes) {
+                    cerr << "error: chunk bytes " << optarg << endl;
+                    exit(EXIT_FAILURE);
+                }
+            }
+            break;
+
+        case ('m') : // message
+            if (!asciiHexToVector(optarg, msg)) {
+                cerr << "error: message in hex: " << optarg << endl;
+                exit(EXIT_FAILURE);
+            }
+            bm = true;
+            break;
+
+        case ('u') : // leaf index
+            {
+                stringstream ss(optarg);
+                if (!(ss >> index)) {
+                    cerr << "error: leaf index " << optarg << endl;
+                    exit(EXIT_FAILURE);
+                }
+            }
+            bu = true;
+            break;
+
+        case ('v') : // new chunk
+            if (!asciiHexToVector(optarg, chunk)) {
+                cerr << "error: chunk in hex: " << optarg << endl;
+                exit(EXIT_FAILURE);
+            }
+            bv = true;
+            break;
+
+        default :
+            printUsage(argv[0]);
+        }
+    }
+
+    if (bm && 0 != chunkBytes && bu == bv) {
+        switch (shaBits) {
+        case (1) : runMerkle<SHA1>(chunkBytes, msg, bu, index, chunk); return EXIT_SUCCESS;
+        case (256) : runMerkle<SHA256>(chunkBytes, msg, bu, index, chunk); return EXIT_SUCCESS;
+        }
+    }
+
+    printUsage(argv[0]);
+}
@@ -0,0 +1,81 @@
+#!/bin/bash
+
+# Merkle tree roots from MerkleTree and MerkleIncremental (all leaves at
+# once and appended one at a time) must agree, every inclusion proof must
+# verify, and a changed leaf must give the same root as a rebuilt tree.
+# Messages are bytes 0, 1, 2, ... modulo 251 in 64-byte chunks. Expected
+# roots are computed with Python hashlib:
+#   leaf = H(0x00 || chunk)
+#   node = H(0x01 || left || right) for SHA-1
+#   node = H(0x01 || 63 zero bytes || left || right) for SHA-256
+# The 2186-byte message has 35 leaves, 17 pairs at the bottom level, more
+# than the SIMD lanes hold and not a multiple of them.
+
+FAIL_COUNT=0
+
+# octet in hex repeated N times
+rep() {
+    printf "$1%.0s" `seq 1 $2`
+}
+
+# N bytes of the test pattern in hex
+pattern() {
+    awk -v n=$1 'BEGIN { for (i = 0; i < n; ++i) printf "%02x", i % 251 }'
+}
+
+# checkRoot bits chunk_bytes message_bytes expected_root
+checkRoot() {
+    MD=`./MERKLE_test -a $1 -t $2 -m "\`pattern $3\`" | awk '{print $2}'`
+    if [ "$MD" == "$4" ]
+    then
+        echo "OK SHA"$1" "$3" bytes -t "$2
+    else
+        echo "FAIL SHA"$1" "$3" bytes -t "$2
+        FAIL_COUNT=`expr $FAIL_COUNT + 1`
+    fi
+}
+
+# checkUpdate bits chunk_bytes message_bytes leaf new_chunk_in_hex
+#             expected_root expected_updated_root
+checkUpdate() {
+    OUT=`./MERKLE_test -a $1 -t $2 -m "\`pattern $3\`" -u $4 -v "$5"`
+    ROOT=`echo "$OUT" | awk '/^ROOT:/ {print $2}'`
+    UPDATE=`echo "$OUT" | awk '/^UPDATE:/ {print $2}'`
+    if [ "$ROOT" == "$6" -a "$UPDATE" == "$7" ]
+    then
+        echo "OK SHA"$1" "$3" bytes -t "$2" leaf "$4
+    else
+        echo "FAIL SHA"$1" "$3" bytes -t "$2" leaf "$4
+        FAIL_COUNT=`expr $FAIL_COUNT + 1`
+    fi
+}
+
+checkRoot 1 64 0 5ba93c9db0cff93f52b521d7420e43f6eda2784f
+checkRoot 1 64 1 1489f923c4dca729178b3e3233458550d8dddf29
+checkRoot 1 64 64 322bd22cf094ad8240eb9ffdae847d2635ba6bca
+checkRoot 1 64 100 55f9ff429cfe9d8d35581e9d75c401e29fde8f8f
+checkRoot 1 64 200 2b41ceb956752ffe37c73de42497f84899baedcc
+checkRoot 1 64 1024 6bc64f360d7c5aa5d219ec3ec3a299942b783c9e
+checkRoot 1 64 2186 0fe1e2b273b506d10c34940a801e75079817419e
+checkUpdate 1 64 2186 3 `rep ff 64` 0fe1e2b273b506d10c34940a801e75079817419e 593d8af0868c4811158dcaba6dc28f0d5eb103d7
+checkUpdate 1 64 2186 34 `rep ff 5` 0fe1e2b273b506d10c34940a801e75079817419e 9739f2f8c8c5e548caa5126454c6833d23be2e2b
+checkUpdate 1 64 100 0 "" 55f9ff429cfe9d8d35581e9d75c401e29fde8f8f 24dd58d96ab67f4e1c4ffa69541cf0c29d9dba82
+
+checkRoot 256 64 0 6e340b9cffb37a989ca544e6bb780a2c78901d3fb33738768511a30617afa01d
+checkRoot 256 64 1 96a296d224f285c67bee93c30f8a309157f0daa35dc5b87e410b78630a09cfc7
+checkRoot 256 64 64 e4fb1329f08b46df92906ff0be9b7ab12c44eabd3eb8651e69edb27bd8a19e95
+checkRoot 256 64 100 3d7f3db20c8a5bf05f9813f852a62cf2535e2b26b95fb12d2636d7006d7a6296
+checkRoot 256 64 200 aa4d0c07052c879b4d5c09f38b89716b549c6ddf284f0d953205f4aa6dd6a829
+checkRoot 256 64 1024 c230e7565c589c05de985da41ce3d1768191ae19e2f25a6e4292c958115aa74a
+checkRoot 256 64 2186 5bde73cabf8103eecfd4b958f5bc8777ec04a6c4a0b9bd941683c3e4b318aa91
+checkUpdate 256 64 2186 3 `rep ff 64` 5bde73cabf8103eecfd4b958f5bc8777ec04a6c4a0b9bd941683c3e4b318aa91 5f46d586fb576036586619e59cdeee922f47068b9d874ca37323c95d715f8767
+checkUpdate 256 64 2186 34 `rep ff 5` 5bde73cabf8103eecfd4b958f5bc8777ec04a6c4a0b9bd941683c3e4b318aa91 2f8fd56c5856f3e9460b4f874e7fa6c58491249f4fe633f0a961f50cd5ef9794
+checkUpdate 256 64 100 0 "" 3d7f3db20c8a5bf05f9813f852a62cf2535e2b26b95fb12d2636d7006d7a6296 dc69aaa09a8228c54b88c2b6e679716b0cca51abfbc66cb00be377b842eedd53
+
+echo
+if [ $FAIL_COUNT == 0 ]
+then
+    echo All tests passed
+else
+    echo "There were "$FAIL_COUNT" failures"
+fi
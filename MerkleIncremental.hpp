@@ -0,0 +1,201 @@
+#ifndef _CRYPTL_MERKLE_INCREMENTAL_HPP_
+#define _CRYPTL_MERKLE_INCREMENTAL_HPP_
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+#include <cryptl/MerkleTree.hpp>
+#include <cryptl/SHA_256.hpp>
+
+namespace cryptl {
+
+////////////////////////////////////////////////////////////////////////////////
+// Merkle tree kept in memory for leaf updates and inclusion proofs
+//
+// T is: SHA1, SHA224, SHA256, SHA384, SHA512, SHA512_224, SHA512_256
+//
+// Leaf and node hashes are the same as MerkleTree, so the roots agree for
+// the same leaves. Every node digest is stored in one flat array in level
+// order (node k has children 2k and 2k + 1, the root is node 1, the leaves
+// start at the capacity). Changing or appending a leaf rehashes only its
+// path to the root. A node with no right sibling moves up unchanged, so a
+// proof has one digest for each level where the sibling exists.
+//
+
+template <typename T>
+class MerkleIncremental
+{
+public:
+    typedef typename T::DigType DigType;
+
+    typedef std::vector<DigType> ProofType;
+
+    MerkleIncremental()
+        : m_size(0),
+          m_capacity(0)
+    {}
+
+    // leaf digests, e.g. from MerkleTree<T>::leafHash()
+    explicit MerkleIncremental(const std::vector<DigType>& leaves)
+        : MerkleIncremental()
+    {
+        assign(leaves);
+    }
+
+    // replace all leaves, builds every level once
+    void assign(const std::vector<DigType>& leaves) {
+        m_size = leaves.size();
+        m_capacity = 1;
+        while (m_capacity < m_size) m_capacity *= 2;
+
+        m_node.assign(2 * m_capacity, DigType());
+
+        for (std::size_t i = 0; i < m_size; ++i) {
+            m_node[m_capacity + i] = leaves[i];
+        }
+
+        // nodes with leaves below them are a prefix of each level
+        std::size_t count = m_size;
+        for (std::size_t first = m_capacity; first > 1; first /= 2) {
+            const std::size_t up = (count + 1) / 2;
+            for (std::size_t j = 0; j < up; ++j) {
+                combine(first / 2 + j, first, count);
+            }
+            count = up;
+        }
+    }
+
+    std::size_t size() const { return m_size; }
+
+    const DigType& leaf(const std::size_t index) const {
+#ifdef USE_ASSERT
+        assert(index < m_size);
+#endif
+        return m_node[m_capacity + index];
+    }
+
+    const DigType& root() const {
+#ifdef USE_ASSERT
+        assert(0 != m_size);
+#endif
+        return m_node[1];
+    }
+
+    // change one leaf digest
+    void update(const std::size_t index, const DigType& leafDigest) {
+#ifdef USE_ASSERT
+        assert(index < m_size);
+#endif
+        m_node[m_capacity + index] = leafDigest;
+        rehashPath(index);
+    }
+
+    // change one leaf to the hash of a chunk
+    void update(const std::size_t index,
+                const std::uint8_t* p,
+                const std::size_t n)
+    {
+        update(index, MerkleTree<T>::leafHash(p, n));
+    }
+
+    // add a leaf at the end, the array doubles when full
+    void append(const DigType& leafDigest) {
+        if (m_size == m_capacity) {
+            std::vector<DigType> leaves(m_node.begin() + m_capacity,
+                                        m_node.begin() + m_capacity + m_size);
+            leaves.push_back(leafDigest);
+            assign(leaves);
+            return;
+        }
+
+        m_node[m_capacity + m_size] = leafDigest;
+        rehashPath(m_size++);
+    }
+
+    void append(const std::uint8_t* p, const std::size_t n) {
+        append(MerkleTree<T>::leafHash(p, n));
+    }
+
+    // sibling digests from the leaf up to the root
+    ProofType proof(const std::size_t index) const {
+#ifdef USE_ASSERT
+        assert(index < m_size);
+#endif
+        ProofType path;
+
+        std::size_t count = m_size, first = m_capacity;
+        for (std::size_t k = first + index; k > 1; k /= 2, first /= 2) {
+            const std::size_t j = k - first;
+            if (j % 2) {
+                path.push_back(m_node[k - 1]);
+            } else if (j + 1 < count) {
+                path.push_back(m_node[k + 1]);
+            }
+            count = (count + 1) / 2;
+        }
+
+        return path;
+    }
+
+    // check a proof against a root, needs the number of leaves in the tree
+    static bool verify(const DigType& rootDigest,
+                       const DigType& leafDigest,
+                       std::size_t index,
+                       std::size_t count,
+                       const ProofType& path)
+    {
+        if (index >= count) return false;
+
+        DigType h = leafDigest;
+        std::size_t used = 0;
+
+        for (; count > 1; index /= 2, count = (count + 1) / 2) {
+            if (index % 2) {
+                if (used == path.size()) return false;
+                h = MerkleTree<T>::nodeHash(path[used++], h);
+            } else if (index + 1 < count) {
+                if (used == path.size()) return false;
+                h = MerkleTree<T>::nodeHash(h, path[used++]);
+            }
+        }
+
+        return used == path.size() && h == rootDigest;
+    }
+
+private:
+    // node k from its children, count nodes on their level starting at first
+    void combine(const std::size_t k,
+                 const std::size_t first,
+                 const std::size_t count)
+    {
+        const std::size_t j = 2 * k - first;
+        m_node[k] = j + 1 < count
+            ? MerkleTree<T>::nodeHash(m_node[2 * k], m_node[2 * k + 1])
+            : m_node[2 * k];
+    }
+
+    void rehashPath(const std::size_t index) {
+        std::size_t count = m_size;
+        std::size_t first = m_capacity;
+        for (std::size_t k = (m_capacity + index) / 2; k >= 1; k /= 2) {
+            combine(k, first, count);
+            first /= 2;
+            count = (count + 1) / 2;
+        }
+    }
+
+    std::size_t m_size, m_capacity;
+
+    std::vector<DigType> m_node;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// typedef
+//
+
+typedef MerkleIncremental<SHA256> MerkleIncremental_SHA256;
+
+} // namespace cryptl
+
+#endif
@@ -0,0 +1,191 @@
+#ifndef _CRYPTL_MERKLE_TREE_HPP_
+#define _CRYPTL_MERKLE_TREE_HPP_
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include <cryptl/Bless.hpp>
+#include <cryptl/Parallel.hpp>
+#include <cryptl/SHA_256.hpp>
+#include <cryptl/SHA_256_Node.hpp>
+#include <cryptl/SHA_Stream.hpp>
+
+namespace cryptl {
+
+////////////////////////////////////////////////////////////////////////////////
+// Merkle tree interior node, H(0x01 || left || right)
+//
+// SHA-256 is specialized: H(N || left || right) where N is the 64-byte
+// block 0x01 followed by zero bytes. The block is precompressed into the
+// initial value (SHA_256_NodeIV), so a node is one compression of the
+// children and one of constant padding, and a run of nodes goes in SIMD
+// lanes.
+//
+
+template <typename T>
+class MerkleNode
+{
+public:
+    typedef typename T::DigType DigType;
+
+    static const std::size_t DIGEST_BYTES =
+        std::tuple_size<DigType>::value * sizeof(typename DigType::value_type);
+
+    static const std::uint8_t NODE_PREFIX = 0x01;
+
+    // hash of 0x01 || left || right
+    static DigType hash(const DigType& left, const DigType& right) {
+        std::array<std::uint8_t, 1 + 2 * DIGEST_BYTES> b;
+        b[0] = NODE_PREFIX;
+        storeBigEndian(b.data() + 1, left);
+        storeBigEndian(b.data() + 1 + DIGEST_BYTES, right);
+
+        SHA_Stream<T> hashStream;
+        hashStream.update(b.data(), b.size());
+        return hashStream.final();
+    }
+
+    // one tree level: parent[i] = hash(child[2i], child[2i + 1]) for i < N
+    static void hash(const DigType* child, const std::size_t N, DigType* parent) {
+        for (std::size_t i = 0; i < N; ++i)
+            parent[i] = hash(child[2 * i], child[2 * i + 1]);
+    }
+};
+
+template <>
+class MerkleNode<SHA256>
+{
+public:
+    typedef SHA256::DigType DigType;
+
+    static DigType hash(const DigType& left, const DigType& right) {
+        return SHA_256_Node::node(left, right);
+    }
+
+    static void hash(const DigType* child, const std::size_t N, DigType* parent) {
+        SHA_256_Node::node(child, N, parent);
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Merkle tree hash of a large message
+//
+// T is: SHA1, SHA224, SHA256, SHA384, SHA512, SHA512_224, SHA512_256
+//
+// The message is split into fixed size chunks. Leaves and interior nodes
+// have different prefixes so a leaf can never be taken for a node:
+//   leaf = H(0x00 || chunk)
+//   node = H(0x01 || left || right), see MerkleNode for SHA-256
+// Levels are combined pairwise, an odd node at the end of a level moves up
+// unchanged. Leaves are hashed in parallel on worker threads, then each
+// level of nodes in parallel, in runs of pairs. The workers are started
+// once, by the tree or by the application when it shares a pool, and
+// reused by every digest().
+//
+
+template <typename T>
+class MerkleTree
+{
+public:
+    typedef typename T::DigType DigType;
+
+    static const std::size_t DIGEST_BYTES =
+        std::tuple_size<DigType>::value * sizeof(typename DigType::value_type);
+
+    static const std::uint8_t LEAF_PREFIX = 0x00, NODE_PREFIX = 0x01;
+
+    // zero threads is one per hardware thread
+    explicit MerkleTree(const std::size_t chunkBytes = 1 << 20,
+                        const std::size_t threads = 0)
+        : MerkleTree(chunkBytes, std::make_shared<WorkerPool>(threads))
+    {}
+
+    // workers shared with the application
+    MerkleTree(const std::size_t chunkBytes,
+               const std::shared_ptr<WorkerPool>& pool)
+        : m_chunkBytes(chunkBytes),
+          m_pool(pool)
+    {
+        if (0 == chunkBytes)
+            throw std::invalid_argument("MerkleTree chunk size is zero");
+    }
+
+    std::size_t chunkBytes() const { return m_chunkBytes; }
+
+    // number of leaves (an empty message is one empty leaf)
+    std::size_t leafCount(const std::size_t n) const {
+        return 0 == n ? 1 : (n + m_chunkBytes - 1) / m_chunkBytes;
+    }
+
+    // root of the tree
+    DigType digest(const std::uint8_t* p, const std::size_t n) const {
+        std::vector<DigType> level(leafCount(n));
+
+        m_pool->run(
+            level.size(),
+            [&] (std::size_t i) {
+                const std::size_t offset = i * m_chunkBytes;
+                const std::size_t len =
+                    n - offset < m_chunkBytes ? n - offset : m_chunkBytes;
+
+                level[i] = leafHash(p + offset, len);
+            });
+
+        while (level.size() > 1) {
+            const std::size_t pairs = level.size() / 2;
+            std::vector<DigType> up(pairs + level.size() % 2);
+
+            m_pool->run(
+                (pairs + NODE_RUN - 1) / NODE_RUN,
+                [&] (std::size_t i) {
+                    const std::size_t k = i * NODE_RUN;
+                    MerkleNode<T>::hash(level.data() + 2 * k,
+                                        pairs - k < NODE_RUN ? pairs - k : NODE_RUN,
+                                        up.data() + k);
+                });
+
+            if (level.size() % 2) up.back() = level.back();
+
+            level.swap(up);
+        }
+
+        return level[0];
+    }
+
+    DigType digest(const std::vector<std::uint8_t>& a) const {
+        return digest(a.data(), a.size());
+    }
+
+    static DigType leafHash(const std::uint8_t* p, const std::size_t n) {
+        const std::uint8_t prefix = LEAF_PREFIX;
+
+        SHA_Stream<T> hashStream;
+        hashStream.update(&prefix, 1);
+        hashStream.update(p, n);
+        return hashStream.final();
+    }
+
+    static DigType nodeHash(const DigType& left, const DigType& right) {
+        return MerkleNode<T>::hash(left, right);
+    }
+
+private:
+    // pairs of a level for one worker, a few thousand nanoseconds of work
+    static const std::size_t NODE_RUN = 64;
+
+    std::size_t m_chunkBytes;
+    std::shared_ptr<WorkerPool> m_pool;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// typedef
+//
+
+typedef MerkleTree<SHA256> MerkleTree_SHA256;
+
+} // namespace cryptl
+
+#endif
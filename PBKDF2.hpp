@@ -0,0 +1,276 @@
+#ifndef _CRYPTL_PBKDF2_HPP_
+#define _CRYPTL_PBKDF2_HPP_
+
+#include <array>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include <cryptl/Bless.hpp>
+#include <cryptl/HMAC.hpp>
+#include <cryptl/SHA_256_MultiBuffer.hpp>
+#include <cryptl/SHA_512_MultiBuffer.hpp>
+#include <cryptl/SHA_MultiBuffer.hpp>
+#include <cryptl/Wipe.hpp>
+
+namespace cryptl {
+
+////////////////////////////////////////////////////////////////////////////////
+// password-based key derivation with HMAC (RFC 8018 section 5.2)
+//
+// T is: SHA1, SHA224, SHA256, SHA384, SHA512
+// LANES is the SIMD compression function (SHA_NoLanes for SHA-1)
+//
+// Every output block of every password is an independent job. Each
+// iteration is two compressions of one fixed-layout block from the HMAC
+// pad midstates, no allocation and no byte conversion. Full groups of jobs
+// run together in SIMD lanes, the rest one at a time.
+//
+
+template <typename T, typename LANES>
+class PBKDF2
+{
+public:
+    typedef typename T::WordType WordType;
+    typedef typename T::DigType DigType;
+    typedef typename T::MidType MidType;
+
+    static_assert(std::is_same<WordType, typename DigType::value_type>::value,
+                  "PBKDF2 digest must be whole hash words");
+
+    static const std::size_t DIGEST_BYTES = HMAC<T>::DIGEST_BYTES;
+
+    PBKDF2() = default;
+
+    // derived key of dkLen bytes from password P and salt S, c iterations
+    void derive(std::uint8_t* dk,
+                const std::size_t dkLen,
+                const std::uint8_t* P,
+                const std::size_t pLen,
+                const std::uint8_t* S,
+                const std::size_t sLen,
+                const std::size_t c) const
+    {
+        derive(1, &dk, dkLen, &P, &pLen, &S, &sLen, c);
+    }
+
+    std::vector<std::uint8_t> derive(const std::vector<std::uint8_t>& P,
+                                     const std::vector<std::uint8_t>& S,
+                                     const std::size_t c,
+                                     const std::size_t dkLen) const
+    {
+        std::vector<std::uint8_t> dk(dkLen);
+        derive(dk.data(), dkLen, P.data(), P.size(), S.data(), S.size(), c);
+        return dk;
+    }
+
+    // batch of N passwords, each with its own salt
+    void derive(const std::size_t N,
+                std::uint8_t* const* dk,
+                const std::size_t dkLen,
+                const std::uint8_t* const* P,
+                const std::size_t* pLen,
+                const std::uint8_t* const* S,
+                const std::size_t* sLen,
+                const std::size_t c) const
+    {
+        const std::size_t blocks = (dkLen + DIGEST_BYTES - 1) / DIGEST_BYTES;
+        std::vector<Job> jobs(N * blocks);
+
+        for (std::size_t k = 0; k < N; ++k) {
+            HMAC<T> prf(P[k], pLen[k]);
+
+            for (std::size_t i = 0; i < blocks; ++i) {
+                Job& job = jobs[k * blocks + i];
+                job.inner = prf.innerMidstate();
+                job.outer = prf.outerMidstate();
+
+                // U_1 = PRF(P, S || INT(i))
+                std::array<std::uint8_t, 4> INT;
+                storeBigEndian(INT.data(), static_cast<std::uint32_t>(i + 1));
+                prf.init();
+                prf.update(S[k], sLen[k]);
+                prf.update(INT.data(), INT.size());
+                job.U = prf.final();
+                job.sum = job.U;
+            }
+        }
+
+        // full groups in SIMD lanes, remainder one at a time
+        const std::size_t L = LANES::lanes();
+        std::size_t j = 0;
+        if (0 != L) {
+            for (; j + L <= jobs.size(); j += L) iterateLanes(&jobs[j], L, c);
+        }
+        for (; j < jobs.size(); ++j) iterate(jobs[j], c);
+
+        // T_1 || T_2 || ... || T_l, truncated to dkLen
+        for (std::size_t k = 0; k < N; ++k) {
+            for (std::size_t i = 0; i < blocks; ++i) {
+                std::array<std::uint8_t, DIGEST_BYTES> b;
+                storeBigEndian(b.data(), jobs[k * blocks + i].sum);
+
+                const std::size_t offset = i * DIGEST_BYTES;
+                for (std::size_t n = 0; n < DIGEST_BYTES && offset + n < dkLen; ++n) {
+                    dk[k][offset + n] = b[n];
+                }
+
+                wipe(b);
+            }
+        }
+
+        for (auto& job : jobs) wipe(job);
+    }
+
+    std::vector<std::vector<std::uint8_t>> derive(
+        const std::vector<std::vector<std::uint8_t>>& P,
+        const std::vector<std::vector<std::uint8_t>>& S,
+        const std::size_t c,
+        const std::size_t dkLen) const
+    {
+        const std::size_t N = P.size();
+        std::vector<std::vector<std::uint8_t>> dk(N, std::vector<std::uint8_t>(dkLen));
+
+        std::vector<std::uint8_t*> dkPtr(N);
+        std::vector<const std::uint8_t*> pPtr(N), sPtr(N);
+        std::vector<std::size_t> pLen(N), sLen(N);
+        for (std::size_t k = 0; k < N; ++k) {
+            dkPtr[k] = dk[k].data();
+            pPtr[k] = P[k].data();
+            pLen[k] = P[k].size();
+            sPtr[k] = S[k].data();
+            sLen[k] = S[k].size();
+        }
+
+        derive(N, dkPtr.data(), dkLen, pPtr.data(), pLen.data(), sPtr.data(), sLen.data(), c);
+        return dk;
+    }
+
+private:
+    static const std::size_t MAX_LANES = LANES::MAX_LANES;
+
+    // words in hash value and digest
+    static const std::size_t HASH_WORDS = sizeof(MidType::H) / sizeof(WordType);
+    static const std::size_t DIGEST_WORDS = DIGEST_BYTES / sizeof(WordType);
+
+    // one output block T_i = U_1 ^ U_2 ^ ... ^ U_c
+    class Job
+    {
+    public:
+        MidType inner, outer;
+        DigType U, sum;
+    };
+
+    // round constants of T
+    class AlgoState : public T
+    {
+    public:
+        const WordType* constants() const {
+            return this->m_K.data();
+        }
+    };
+
+    // message block of one digest: U, bit "1", zero bits, length of
+    // message after the key XOR pad block
+    static void padBlock(std::array<WordType, 16>& W) {
+        W.fill(0);
+        W[DIGEST_WORDS] = static_cast<WordType>(0x80) << (sizeof(WordType) - 1) * CHAR_BIT;
+        W[15] = (16 * sizeof(WordType) + DIGEST_BYTES) * CHAR_BIT;
+    }
+
+    // U_j = PRF(P, U_{j-1}) for j = 2 to c
+    static void iterate(Job& job, const std::size_t c) {
+        std::array<WordType, 16> W;
+        padBlock(W);
+
+        T algo;
+        for (std::size_t r = 1; r < c; ++r) {
+            for (std::size_t i = 0; i < DIGEST_WORDS; ++i) W[i] = job.U[i];
+
+            algo.resumeHash(job.inner);
+            for (const auto& w : W) algo.streamInput(w);
+            const MidType a = algo.midstate();
+            for (std::size_t i = 0; i < DIGEST_WORDS; ++i) W[i] = a.H[i];
+
+            algo.resumeHash(job.outer);
+            for (const auto& w : W) algo.streamInput(w);
+            const MidType b = algo.midstate();
+            for (std::size_t i = 0; i < DIGEST_WORDS; ++i) {
+                job.U[i] = b.H[i];
+                job.sum[i] ^= b.H[i];
+            }
+        }
+
+        wipe(W);
+    }
+
+    // same for L jobs at once, lane state is word-major as in SHA_MultiBuffer
+    static void iterateLanes(Job* jobs, const std::size_t L, const std::size_t c) {
+        alignas(64) std::array<WordType, 8 * MAX_LANES> H, inner, outer, acc;
+        alignas(64) std::array<WordType, 16 * MAX_LANES> W;
+
+        std::array<WordType, 16> pad;
+        padBlock(pad);
+
+        for (std::size_t j = 0; j < L; ++j) {
+            for (std::size_t i = 0; i < HASH_WORDS; ++i) {
+                inner[i * L + j] = jobs[j].inner.H[i];
+                outer[i * L + j] = jobs[j].outer.H[i];
+            }
+
+            for (std::size_t i = 0; i < DIGEST_WORDS; ++i) {
+                W[i * L + j] = jobs[j].U[i];
+                acc[i * L + j] = jobs[j].sum[i];
+            }
+
+            for (std::size_t i = DIGEST_WORDS; i < 16; ++i) {
+                W[i * L + j] = pad[i];
+            }
+        }
+
+        const WordType* K = AlgoState().constants();
+
+        // digest words are the first rows of both H and W
+        const std::size_t HL = HASH_WORDS * L, DL = DIGEST_WORDS * L;
+
+        for (std::size_t r = 1; r < c; ++r) {
+            for (std::size_t i = 0; i < HL; ++i) H[i] = inner[i];
+            LANES::compress(L, H.data(), W.data(), K);
+            for (std::size_t i = 0; i < DL; ++i) W[i] = H[i];
+
+            for (std::size_t i = 0; i < HL; ++i) H[i] = outer[i];
+            LANES::compress(L, H.data(), W.data(), K);
+            for (std::size_t i = 0; i < DL; ++i) {
+                W[i] = H[i];
+                acc[i] ^= H[i];
+            }
+        }
+
+        for (std::size_t j = 0; j < L; ++j) {
+            for (std::size_t i = 0; i < DIGEST_WORDS; ++i) {
+                jobs[j].U[i] = W[i * L + j];
+                jobs[j].sum[i] = acc[i * L + j];
+            }
+        }
+
+        wipe(H);
+        wipe(inner);
+        wipe(outer);
+        wipe(acc);
+        wipe(W);
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// typedefs
+//
+
+typedef PBKDF2<SHA1, SHA_NoLanes> PBKDF2_SHA1;
+
+typedef PBKDF2<SHA256, SHA_256_Lanes> PBKDF2_SHA256;
+
+typedef PBKDF2<SHA512, SHA_512_Lanes> PBKDF2_SHA512;
+
+} // namespace cryptl
+
+#endif
@@ -0,0 +1,138 @@
+#ifndef _CRYPTL_PARALLEL_HPP_
+#define _CRYPTL_PARALLEL_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cryptl {
+
+////////////////////////////////////////////////////////////////////////////////
+// pool of worker threads, run func(i) for i = 0 to N - 1
+//
+// The threads are started once by the constructor and wait between calls
+// to run(), so hashing many small messages does not pay for thread start
+// up each time. Workers take the next index from a shared counter, so
+// uneven work balances itself. The calling thread is one of the workers.
+//
+// This is self-scheduling, not work stealing: there are no per-thread
+// queues, an idle worker just takes the next index. Tasks here are
+// independent and never spawn more, so a stolen task and the next index
+// are the same thing. Callers order tasks largest first (as SHASUM does)
+// so a long one does not start last.
+// Zero threads means one per hardware thread. Applications link with
+// -pthread.
+//
+// Calls to run() from different threads take turns. The function must not
+// call run() on the same pool.
+//
+
+inline std::size_t hardwareThreads() {
+    const std::size_t n = std::thread::hardware_concurrency();
+    return 0 == n ? 1 : n;
+}
+
+class WorkerPool
+{
+public:
+    explicit WorkerPool(const std::size_t threads = 0)
+        : m_func(nullptr),
+          m_N(0),
+          m_next(0),
+          m_generation(0),
+          m_busy(0),
+          m_stop(false)
+    {
+        const std::size_t T = 0 == threads ? hardwareThreads() : threads;
+        for (std::size_t t = 1; t < T; ++t)
+            m_workers.emplace_back([this] () { workerLoop(); });
+    }
+
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_wake.notify_all();
+
+        for (auto& th : m_workers) th.join();
+    }
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator= (const WorkerPool&) = delete;
+
+    // including the calling thread
+    std::size_t threads() const {
+        return m_workers.size() + 1;
+    }
+
+    void run(const std::size_t N, const std::function<void (std::size_t)>& func) {
+        std::lock_guard<std::mutex> turn(m_runMutex);
+
+        if (m_workers.empty() || N <= 1) {
+            for (std::size_t i = 0; i < N; ++i) func(i);
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_func = &func;
+            m_N = N;
+            m_next = 0;
+            m_busy = m_workers.size();
+            ++m_generation;
+        }
+        m_wake.notify_all();
+
+        work();
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_done.wait(lock, [this] () { return 0 == m_busy; });
+        m_func = nullptr;
+    }
+
+private:
+    void work() {
+        for (std::size_t i = m_next++; i < m_N; i = m_next++) (*m_func)(i);
+    }
+
+    void workerLoop() {
+        std::size_t seen = 0;
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true) {
+            m_wake.wait(lock, [&] () { return m_stop || seen != m_generation; });
+            if (m_stop) return;
+            seen = m_generation;
+
+            lock.unlock();
+            work();
+            lock.lock();
+
+            if (0 == --m_busy) m_done.notify_one();
+        }
+    }
+
+    std::vector<std::thread> m_workers;
+
+    // one run() at a time
+    std::mutex m_runMutex;
+
+    // guards everything below except the index counter
+    std::mutex m_mutex;
+    std::condition_variable m_wake, m_done;
+
+    const std::function<void (std::size_t)>* m_func;
+    std::size_t m_N;
+    std::atomic<std::size_t> m_next;
+    std::size_t m_generation, m_busy;
+    bool m_stop;
+};
+
+} // namespace cryptl
+
+#endif
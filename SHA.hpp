@@ -1,12 +1,16 @@
 #ifndef _CRYPTL_SHA_HPP_
 #define _CRYPTL_SHA_HPP_
 
+#include <array>
 #include <cassert>
 #include <climits>
 #include <cstdint>
 #include <ostream>
+#include <type_traits>
 #include <vector>
 
+#include <cryptl/Wipe.hpp>
+
 namespace cryptl {
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -89,6 +93,7 @@ public:
 
     void clearMessage() {
         m_message.clear();
+        m_appendBlocks = 0;
     }
 
     void computeHash() {
@@ -100,26 +105,166 @@ public:
 
         ptr->initHashValue();
 
-        std::size_t msgIndex = 0;
-        while (msgIndex < m_message.size()) {
-            ptr->prepMsgSchedule(msgIndex);
-            ptr->initWorkingVars();
-            ptr->workingLoop();
-            ptr->updateHash();
+        for (std::size_t i = 0; i < m_message.size(); i += 16) {
+            ptr->compressBlock(&m_message[i]);
+        }
+
+        ptr->afterHash();
+    }
+
+    // append-only message: msgInput() words of the message without padding,
+    // then computeHashAppended() whenever a digest is needed. Full blocks
+    // are compressed once over all calls, the chaining value after them is
+    // kept and the padding is hashed on a copy of it. The message length is
+    // a whole number of words.
+    void computeHashAppended() {
+#ifdef USE_ASSERT
+        assert(m_appendBlocks <= m_message.size() / 16);
+#endif
+
+        typedef typename CRTP::WordType W;
+
+        auto* ptr = static_cast<CRTP*>(this);
+
+        if (0 == m_appendBlocks) {
+            ptr->initHashValue();
+        } else {
+            ptr->restoreChain();
+        }
+
+        const std::size_t fullBlocks = m_message.size() / 16;
+        for (; m_appendBlocks < fullBlocks; ++m_appendBlocks) {
+            ptr->compressBlock(&m_message[16 * m_appendBlocks]);
+        }
+
+        ptr->saveChain();
+
+        // remaining words, bit "1", zero bits, length of message
+        std::array<MSG, 32> tail;
+        std::size_t n = 0;
+        for (std::size_t i = 16 * fullBlocks; i < m_message.size(); ++i) {
+            tail[n++] = m_message[i];
+        }
+
+        tail[n++] = MSG(static_cast<W>(W(1) << (wordSizeBits() - 1)));
+
+        const std::size_t tailWords = n + 2 > 16 ? 32 : 16;
+        while (tailWords - 2 != n) tail[n++] = MSG(W(0));
+
+        const std::uint64_t lengthBits =
+            static_cast<std::uint64_t>(m_message.size()) * wordSizeBits();
+
+        if (SHA_BlockSize::BLOCK_1024 == BLK) {
+            tail[n++] = MSG(W(0));
+            tail[n++] = MSG(static_cast<W>(lengthBits));
+        } else {
+            tail[n++] = MSG(static_cast<W>(lengthBits >> 32));
+            tail[n++] = MSG(static_cast<W>(lengthBits & 0xffffffff));
+        }
+
+        for (std::size_t i = 0; i < tailWords; i += 16) {
+            ptr->compressBlock(&tail[i]);
         }
 
         ptr->afterHash();
     }
 
+    // incremental hash computation (one message block is buffered in the
+    // object, nothing is allocated):
+    //   initHash(), streamInput() each word of the padded message, finalHash()
+    void initHash() {
+        m_blockWords = 0;
+        m_blockCount = 0;
+        static_cast<CRTP*>(this)->initHashValue();
+    }
+
+    // append word to message, compress block as soon as it is full
+    template <typename T>
+    void streamInput(const T& a) {
+        m_block[m_blockWords++] = MSG(a);
+
+        if (m_block.size() == m_blockWords) {
+            static_cast<CRTP*>(this)->compressBlock(m_block.data());
+            m_blockWords = 0;
+            ++m_blockCount;
+        }
+    }
+
+    // copy of the streamed hash in progress: intermediate hash value and
+    // partial block only, no message vector, message schedule or working
+    // variables (e.g. to branch many messages from a common prefix)
+    CRTP fork() const {
+        CRTP a;
+        a.forkFrom(*static_cast<const CRTP*>(this));
+        return a;
+    }
+
+    // same as fork() but into an existing object
+    void forkFrom(const CRTP& other) {
+        static_cast<CRTP*>(this)->forkHash(other);
+
+        const SHA_Base& b = other;
+        for (std::size_t i = 0; i < b.m_blockWords; ++i) m_block[i] = b.m_block[i];
+        m_blockWords = b.m_blockWords;
+        m_blockCount = b.m_blockCount;
+    }
+
+    // zero the hash state, the partial block and the message words (e.g.
+    // when the message is secret), the hash must be initialized again
+    // before reuse
+    void wipeHash() {
+        for (auto& a : m_message) wipeIfPlain(a);
+        wipeIfPlain(m_block);
+        m_blockWords = 0;
+        static_cast<CRTP*>(this)->wipeState();
+    }
+
+    void finalHash() {
+#ifdef USE_ASSERT
+        // padded message ends on a block boundary
+        assert(0 == m_blockWords);
+#endif
+
+        static_cast<CRTP*>(this)->afterHash();
+    }
+
 protected:
     SHA_Base() = default;
 
-    // note: reference not const so assignment can unbox laziness
-    MSG& msgWord(std::size_t& index) {
-        return m_message[index++];
+    // length of streamed message, only at a block boundary
+    std::uint64_t streamLengthBits() const {
+#ifdef USE_ASSERT
+        assert(0 == m_blockWords);
+#endif
+
+        return m_blockCount * blockSizeBits();
+    }
+
+    // continue streaming after lengthBits of message (derived class has
+    // already restored the intermediate hash value)
+    void streamResume(const std::uint64_t lengthBits) {
+#ifdef USE_ASSERT
+        assert(0 == lengthBits % blockSizeBits());
+#endif
+
+        m_blockWords = 0;
+        m_blockCount = lengthBits / blockSizeBits();
+    }
+
+    // sixteen message words into the intermediate hash value
+    // (hidden by derived classes with an accelerated compression function)
+    // note: pointer not const so assignment can unbox laziness
+    void compressBlock(MSG* M) {
+        auto* ptr = static_cast<CRTP*>(this);
+
+        ptr->prepMsgSchedule(M);
+        ptr->initWorkingVars();
+        ptr->workingLoop();
+        ptr->updateHash();
     }
 
 private:
+
     static void append(std::ostream& os,
                        std::size_t& lengthBits,
                        const char c) {
@@ -148,6 +293,101 @@ private:
     }
 
     std::vector<MSG> m_message;
+
+    // full blocks of m_message in the chaining value, computeHashAppended()
+    std::size_t m_appendBlocks = 0;
+
+    // partial block and number of blocks compressed by streamInput()
+    std::array<MSG, 16> m_block;
+    std::size_t m_blockWords = 0;
+    std::uint64_t m_blockCount = 0;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// most derived class for SHA_Base
+//
+// SHA-224 derives from SHA-256 and SHA-384, SHA-512/224, SHA-512/256 derive
+// from SHA-512. They pass themselves as DERIVED so the base class calls their
+// initHashValue() and afterHash() directly, without virtual functions.
+//
+
+template <typename SELF, typename DERIVED>
+class SHA_Derived
+{
+public:
+    typedef DERIVED type;
+};
+
+template <typename SELF>
+class SHA_Derived<SELF, void>
+{
+public:
+    typedef SELF type;
+};
+
+template <typename SELF, typename DERIVED>
+using SHA_CRTP = typename SHA_Derived<SELF, DERIVED>::type;
+
+////////////////////////////////////////////////////////////////////////////////
+// SHA midstate
+//
+// Intermediate hash value and message length at a block boundary. A common
+// message prefix is compressed once, then many messages resume from it.
+//
+
+template <typename T, std::size_t N>
+class SHA_Midstate
+{
+public:
+    std::array<T, N> H;
+    std::uint64_t lengthBits;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// SHA constant words
+//
+// TABLE has the literal values. Managed word types need a copy in every
+// object as each constant is a variable. Built-in integer words read the
+// shared static table directly, there is nothing to construct or copy.
+//
+
+template <typename T,
+          typename F,
+          typename TABLE,
+          bool SHARED = std::is_same<T, typename TABLE::ArrayType::value_type>::value>
+class SHA_Constants
+{
+public:
+    SHA_Constants() {
+        const auto& a = TABLE::values();
+        for (std::size_t i = 0; i < a.size(); ++i) {
+            m_value[i] = F::constant(a[i]);
+        }
+    }
+
+    const T& operator[] (const std::size_t i) const {
+        return m_value[i];
+    }
+
+    const T* data() const {
+        return m_value.data();
+    }
+
+private:
+    std::array<T, std::tuple_size<typename TABLE::ArrayType>::value> m_value;
+};
+
+template <typename T, typename F, typename TABLE>
+class SHA_Constants<T, F, TABLE, true>
+{
+public:
+    const T& operator[] (const std::size_t i) const {
+        return TABLE::values()[i];
+    }
+
+    const T* data() const {
+        return TABLE::values().data();
+    }
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,667 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+#include "cryptl/ASCII_Hex.hpp"
+#include "cryptl/MerkleIncremental.hpp"
+#include "cryptl/MerkleTree.hpp"
+#include "cryptl/Parallel.hpp"
+#include "cryptl/SHA_1.hpp"
+#include "cryptl/SHA_224.hpp"
+#include "cryptl/SHA_256.hpp"
+#include "cryptl/SHA_256_MultiBuffer.hpp"
+#include "cryptl/SHA_384.hpp"
+#include "cryptl/SHA_512.hpp"
+#include "cryptl/SHA_512_224.hpp"
+#include "cryptl/SHA_512_256.hpp"
+#include "cryptl/SHA_512_MultiBuffer.hpp"
+#include "cryptl/SHA_MultiBuffer.hpp"
+#include "cryptl/SHA_Stream.hpp"
+
+using namespace cryptl;
+using namespace std;
+
+// read() buffer, page aligned
+const size_t READ_BYTES = 1 << 20;
+
+// mapped files are hashed one window at a time, the next window is
+// read ahead while the current one is hashed
+const size_t WINDOW_BYTES = 16 << 20;
+
+// files this small are read whole and hashed together in SIMD lanes,
+// up to a batch of so many files or bytes
+const size_t SMALL_BYTES = 64 << 10;
+const size_t BATCH_FILES = 64;
+const size_t BATCH_BYTES = 4 << 20;
+
+struct Options
+{
+    bool useMmap = true;
+
+    // zero is one per hardware thread
+    size_t threads = 1;
+
+    // zero is a plain digest, otherwise the Merkle tree root with chunks
+    // of this size (same as class MerkleTree)
+    size_t treeChunk = 0;
+};
+
+// digest as hexadecimal text, or errno if the file could not be read
+struct FileDigest
+{
+    string MD;
+    int error = 0;
+};
+
+void printUsage(const char* exeName) {
+    cerr << "usage: "
+         << exeName
+         << " [-a 1|224|256|384|512|512224|512256] [-r] [-c] [-j threads]"
+            " [-t chunk_bytes] [file...]"
+         << endl
+         << "  -a  algorithm, default 1" << endl
+         << "  -r  read() files, do not mmap them" << endl
+         << "  -c  read checksums from the files and check them" << endl
+         << "  -j  hash files on this many threads, 0 is one per hardware"
+            " thread" << endl
+         << "  -t  Merkle tree root instead of the plain digest, leaves"
+            " are chunks of this size" << endl;
+
+    exit(EXIT_FAILURE);
+}
+
+// whole file with mmap, false if it can not be mapped
+//
+// STREAM is SHA_Stream<T> for a plain digest, or TreeStream<T> for a
+// Merkle tree root
+template <typename STREAM>
+bool hashMapped(const int fd, STREAM& hashStream)
+{
+    struct stat sb;
+    if (-1 == fstat(fd, &sb) || !S_ISREG(sb.st_mode) || 0 == sb.st_size)
+        return false;
+
+    const size_t len = sb.st_size;
+
+    void* addr = mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (MAP_FAILED == addr)
+        return false;
+
+    // advice only, errors do not matter
+    madvise(addr, len, MADV_SEQUENTIAL);
+#ifdef MADV_HUGEPAGE
+    madvise(addr, len, MADV_HUGEPAGE);
+#endif
+
+    const uint8_t* p = static_cast<const uint8_t*>(addr);
+
+    for (size_t offset = 0; offset < len; offset += WINDOW_BYTES) {
+        const size_t n = len - offset < WINDOW_BYTES ? len - offset : WINDOW_BYTES;
+
+        if (offset + n < len) {
+            const size_t ahead = len - offset - n;
+            madvise(const_cast<uint8_t*>(p + offset + n),
+                    ahead < WINDOW_BYTES ? ahead : WINDOW_BYTES,
+                    MADV_WILLNEED);
+        }
+
+        hashStream.update(p + offset, n);
+
+        // done with these pages, keeps the resident set small
+        madvise(const_cast<uint8_t*>(p + offset), n, MADV_DONTNEED);
+    }
+
+    munmap(addr, len);
+    return true;
+}
+
+// pipes, terminals and anything else mmap can not do
+template <typename STREAM>
+bool hashRead(const int fd, STREAM& hashStream)
+{
+#ifdef POSIX_FADV_SEQUENTIAL
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+    void* buf = nullptr;
+    if (0 != posix_memalign(&buf, sysconf(_SC_PAGESIZE), READ_BYTES))
+        return false;
+
+    unique_ptr<uint8_t, decltype(&free)> buffer(static_cast<uint8_t*>(buf),
+                                                &free);
+
+    while (true) {
+        const ssize_t n = read(fd, buffer.get(), READ_BYTES);
+
+        if (0 == n) break;
+
+        if (-1 == n) {
+            if (EINTR == errno) continue;
+            return false;
+        }
+
+        hashStream.update(buffer.get(), n);
+    }
+
+    return true;
+}
+
+// file into the stream, "-" is standard input
+template <typename STREAM>
+bool hashFile(const string& fileName, const bool useMmap, STREAM& hashStream)
+{
+    const bool isStdin = "-" == fileName;
+
+    const int fd = isStdin ? STDIN_FILENO : open(fileName.c_str(), O_RDONLY);
+    if (-1 == fd)
+        return false;
+
+    const bool result = (useMmap && hashMapped(fd, hashStream)) ||
+                        hashRead(fd, hashStream);
+
+    if (!isStdin) close(fd);
+
+    return result;
+}
+
+// Merkle tree root of a stream, same as class MerkleTree
+//
+// Used when the file can not be split into leaf tasks: standard input,
+// pipes, read() with -r, or a file that could not be mapped. Leaves are
+// hashed as the bytes arrive, only the leaf digests are kept.
+template <typename T>
+class TreeStream
+{
+public:
+    typedef typename T::DigType DigType;
+
+    explicit TreeStream(const size_t chunkBytes)
+        : m_chunkBytes(chunkBytes)
+    {
+        startLeaf();
+    }
+
+    void update(const uint8_t* p, size_t n) {
+        while (0 != n) {
+            // a full leaf is closed only when more bytes follow, so a
+            // message of whole chunks has no empty leaf at the end
+            if (m_chunkBytes == m_leafBytes) {
+                m_leaves.push_back(m_leaf.final());
+                startLeaf();
+            }
+
+            const size_t k = min(n, m_chunkBytes - m_leafBytes);
+            m_leaf.update(p, k);
+            m_leafBytes += k;
+            p += k;
+            n -= k;
+        }
+    }
+
+    // an empty message is one empty leaf
+    DigType final() {
+        m_leaves.push_back(m_leaf.final());
+        return MerkleIncremental<T>(m_leaves).root();
+    }
+
+private:
+    void startLeaf() {
+        const uint8_t prefix = MerkleTree<T>::LEAF_PREFIX;
+
+        m_leaf.init();
+        m_leaf.update(&prefix, 1);
+        m_leafBytes = 0;
+    }
+
+    const size_t m_chunkBytes;
+    SHA_Stream<T> m_leaf;
+    size_t m_leafBytes;
+    vector<DigType> m_leaves;
+};
+
+// whole file mapped for reading, null if it can not be
+const uint8_t* mapFile(const string& fileName, const size_t len)
+{
+    const int fd = open(fileName.c_str(), O_RDONLY);
+    if (-1 == fd)
+        return nullptr;
+
+    void* addr = mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    return MAP_FAILED == addr ? nullptr : static_cast<const uint8_t*>(addr);
+}
+
+// whole small file after offset bytes of room for a prefix
+bool readSmall(const string& fileName, const size_t offset, vector<uint8_t>& v)
+{
+    const int fd = open(fileName.c_str(), O_RDONLY);
+    if (-1 == fd)
+        return false;
+
+    struct stat sb;
+    if (-1 == fstat(fd, &sb)) {
+        close(fd);
+        return false;
+    }
+
+    v.resize(offset + sb.st_size);
+
+    size_t len = offset;
+    while (len < v.size()) {
+        const ssize_t n = read(fd, v.data() + len, v.size() - len);
+
+        if (0 == n) break;
+
+        if (-1 == n) {
+            if (EINTR == errno) continue;
+            close(fd);
+            return false;
+        }
+
+        len += n;
+    }
+
+    v.resize(len);
+    close(fd);
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// many files on a pool of threads
+//
+// The work is split into tasks: a batch of small files for the multi-buffer
+// lanes, one whole file, or one chunk of a large file in tree mode. Tasks
+// are handed out largest first from a shared counter, so big files start
+// early and small ones fill the gaps at the end. Results are stored by file
+// index, output is always in input order.
+//
+// A large file in tree mode is mapped by whichever of its leaf tasks runs
+// first, so the main thread only lists the files and mapping overlaps with
+// hashing. If it can not be mapped, that task hashes the whole file with
+// read() and the other leaf tasks of the file do nothing.
+//
+
+template <typename T, typename MB>
+vector<FileDigest> hashFiles(const vector<string>& files, const Options& opt)
+{
+    typedef typename T::DigType DigType;
+
+    const uint8_t LEAF_PREFIX = MerkleTree<T>::LEAF_PREFIX;
+    const size_t prefixBytes = 0 == opt.treeChunk ? 0 : 1;
+
+    enum TaskKind { BATCH, WHOLE, LEAF };
+
+    struct Task
+    {
+        TaskKind kind;
+        size_t bytes;
+        vector<size_t> batch;
+        size_t file, leaf;
+    };
+
+    // large file in tree mode, mapped by the first of its leaf tasks
+    struct TreeFile
+    {
+        once_flag mapped;
+        const uint8_t* p = nullptr;
+        size_t len = 0;
+        vector<DigType> leaves;
+    };
+
+    vector<FileDigest> result(files.size());
+    vector<TreeFile> trees(files.size());
+    vector<Task> tasks;
+
+    vector<size_t> small;
+    size_t smallBytes = 0;
+
+    const auto flushSmall = [&] () {
+        if (small.empty()) return;
+        tasks.push_back(Task{BATCH, smallBytes, small, 0, 0});
+        small.clear();
+        smallBytes = 0;
+    };
+
+    for (size_t i = 0; i < files.size(); ++i) {
+        struct stat sb;
+        if ("-" == files[i] ||
+            -1 == stat(files[i].c_str(), &sb) ||
+            !S_ISREG(sb.st_mode)) {
+            // standard input, errors show up when the task opens the file
+            tasks.push_back(Task{WHOLE, SIZE_MAX, {}, i, 0});
+            continue;
+        }
+
+        const size_t len = sb.st_size;
+
+        // in tree mode, any file of more than one leaf is a tree, the
+        // small file batches are only for single leaves
+        if (0 != opt.treeChunk && len > opt.treeChunk) {
+            if (!opt.useMmap) {
+                tasks.push_back(Task{WHOLE, len, {}, i, 0});
+                continue;
+            }
+
+            TreeFile& tree = trees[i];
+            tree.len = len;
+            tree.leaves.resize((len + opt.treeChunk - 1) / opt.treeChunk);
+
+            for (size_t j = 0; j < tree.leaves.size(); ++j) {
+                const size_t offset = j * opt.treeChunk;
+                tasks.push_back(
+                    Task{LEAF,
+                         len - offset < opt.treeChunk ? len - offset : opt.treeChunk,
+                         {}, i, j});
+            }
+
+        } else if (len <= SMALL_BYTES) {
+            small.push_back(i);
+            smallBytes += len;
+            if (BATCH_FILES == small.size() || smallBytes >= BATCH_BYTES)
+                flushSmall();
+
+        } else {
+            tasks.push_back(Task{WHOLE, len, {}, i, 0});
+        }
+    }
+
+    flushSmall();
+
+    stable_sort(tasks.begin(),
+                tasks.end(),
+                [] (const Task& a, const Task& b) { return a.bytes > b.bytes; });
+
+    const auto runTask = [&] (const size_t t) {
+        const Task& task = tasks[t];
+
+        switch (task.kind) {
+        case (BATCH) :
+            {
+                vector<vector<uint8_t>> msg;
+                vector<size_t> index;
+                for (const auto i : task.batch) {
+                    vector<uint8_t> v;
+                    if (!readSmall(files[i], prefixBytes, v)) {
+                        result[i].error = errno;
+
+                    } else if (0 != prefixBytes && v.size() - 1 > opt.treeChunk) {
+                        // grew past one leaf since it was listed
+                        TreeStream<T> hashStream(opt.treeChunk);
+                        hashStream.update(v.data() + 1, v.size() - 1);
+                        result[i].MD = asciiHex(hashStream.final());
+
+                    } else {
+                        if (0 != prefixBytes) v[0] = LEAF_PREFIX;
+                        msg.emplace_back(move(v));
+                        index.push_back(i);
+                    }
+                }
+
+                const auto out = MB().digest(msg);
+                for (size_t k = 0; k < out.size(); ++k)
+                    result[index[k]].MD = asciiHex(out[k]);
+            }
+            break;
+
+        case (WHOLE) :
+            if (0 == opt.treeChunk) {
+                SHA_Stream<T> hashStream;
+                if (hashFile(files[task.file], opt.useMmap, hashStream))
+                    result[task.file].MD = asciiHex(hashStream.final());
+                else
+                    result[task.file].error = errno;
+
+            } else {
+                TreeStream<T> hashStream(opt.treeChunk);
+                if (hashFile(files[task.file], opt.useMmap, hashStream))
+                    result[task.file].MD = asciiHex(hashStream.final());
+                else
+                    result[task.file].error = errno;
+            }
+            break;
+
+        case (LEAF) :
+            {
+                TreeFile& tree = trees[task.file];
+
+                call_once(
+                    tree.mapped,
+                    [&] () {
+                        tree.p = mapFile(files[task.file], tree.len);
+                        if (nullptr != tree.p) return;
+
+                        TreeStream<T> hashStream(opt.treeChunk);
+                        if (hashFile(files[task.file], false, hashStream))
+                            result[task.file].MD = asciiHex(hashStream.final());
+                        else
+                            result[task.file].error = errno;
+                    });
+
+                if (nullptr == tree.p) break;
+
+                const uint8_t* p = tree.p + task.leaf * opt.treeChunk;
+
+                madvise(const_cast<uint8_t*>(p), task.bytes, MADV_WILLNEED);
+                tree.leaves[task.leaf] = MerkleTree<T>::leafHash(p, task.bytes);
+                madvise(const_cast<uint8_t*>(p), task.bytes, MADV_DONTNEED);
+            }
+            break;
+        }
+    };
+
+    // hashFiles() runs once per process, so are the workers started
+    WorkerPool pool(opt.threads);
+    pool.run(tasks.size(), runTask);
+
+    // roots of the large files, one node per chunk so this is quick
+    for (size_t i = 0; i < files.size(); ++i) {
+        TreeFile& tree = trees[i];
+        if (nullptr == tree.p) continue;
+
+        result[i].MD = asciiHex(MerkleIncremental<T>(tree.leaves).root());
+        munmap(const_cast<uint8_t*>(tree.p), tree.len);
+    }
+
+    return result;
+}
+
+vector<FileDigest> hashFiles(const size_t shaBits,
+                             const vector<string>& files,
+                             const Options& opt)
+{
+    switch (shaBits) {
+    case (1) :
+        return hashFiles<SHA1, SHA_MultiBuffer<SHA1, SHA_NoLanes>>(files, opt);
+    case (224) :
+        return hashFiles<SHA224, SHA224_MultiBuffer>(files, opt);
+    case (256) :
+        return hashFiles<SHA256, SHA256_MultiBuffer>(files, opt);
+    case (384) :
+        return hashFiles<SHA384, SHA384_MultiBuffer>(files, opt);
+    case (512) :
+        return hashFiles<SHA512, SHA512_MultiBuffer>(files, opt);
+    case (512224) :
+        return hashFiles<SHA512_224, SHA512_224_MultiBuffer>(files, opt);
+    case (512256) :
+        return hashFiles<SHA512_256, SHA512_256_MultiBuffer>(files, opt);
+    }
+
+    return vector<FileDigest>(files.size());
+}
+
+void printError(const char* exeName, const string& fileName, const int error) {
+    cerr << exeName << ": " << fileName << ": " << strerror(error) << endl;
+}
+
+// same output as sha256sum and friends: digest, two spaces, file name
+bool printLoop(const char* exeName,
+               const size_t shaBits,
+               const Options& opt,
+               const vector<string>& files)
+{
+    bool allOK = true;
+
+    const auto result = hashFiles(shaBits, files, opt);
+
+    for (size_t i = 0; i < files.size(); ++i) {
+        if (0 == result[i].error) {
+            cout << result[i].MD << "  " << files[i] << '\n';
+        } else {
+            printError(exeName, files[i], result[i].error);
+            allOK = false;
+        }
+    }
+
+    return allOK;
+}
+
+// lines are "digest  file name" or "digest *file name"
+bool checkLoop(const char* exeName,
+               const size_t shaBits,
+               const Options& opt,
+               const vector<string>& files)
+{
+    size_t badLines = 0, badReads = 0, badDigests = 0;
+
+    vector<string> expectMD, fileNames;
+
+    for (const auto& listName : files) {
+        ifstream ifs;
+        if ("-" != listName) {
+            ifs.open(listName);
+            if (!ifs) {
+                printError(exeName, listName, errno);
+                ++badReads;
+                continue;
+            }
+        }
+
+        istream& is = "-" == listName ? cin : ifs;
+
+        string line;
+        while (getline(is, line)) {
+            const size_t sep = line.find(' ');
+            if (string::npos == sep || sep + 2 > line.size() ||
+                (' ' != line[sep + 1] && '*' != line[sep + 1])) {
+                ++badLines;
+                continue;
+            }
+
+            expectMD.push_back(line.substr(0, sep));
+            fileNames.push_back(line.substr(sep + 2));
+        }
+    }
+
+    const auto result = hashFiles(shaBits, fileNames, opt);
+
+    for (size_t i = 0; i < fileNames.size(); ++i) {
+        if (0 != result[i].error) {
+            printError(exeName, fileNames[i], result[i].error);
+            cout << fileNames[i] << ": FAILED open or read" << endl;
+            ++badReads;
+        } else if (result[i].MD != expectMD[i]) {
+            cout << fileNames[i] << ": FAILED" << endl;
+            ++badDigests;
+        } else {
+            cout << fileNames[i] << ": OK" << endl;
+        }
+    }
+
+    if (0 != badLines)
+        cerr << exeName << ": WARNING: " << badLines
+             << " line(s) improperly formatted" << endl;
+
+    if (0 != badReads)
+        cerr << exeName << ": WARNING: " << badReads
+             << " listed file(s) could not be read" << endl;
+
+    if (0 != badDigests)
+        cerr << exeName << ": WARNING: " << badDigests
+             << " computed checksum(s) did NOT match" << endl;
+
+    return 0 == badLines && 0 == badReads && 0 == badDigests;
+}
+
+int main(int argc, char *argv[])
+{
+    size_t shaBits = 1;
+    bool checkMode = false;
+    Options opt;
+    int opt_c;
+    while (-1 != (opt_c = getopt(argc, argv, "a:rcj:t:"))) {
+        switch (opt_c) {
+        case ('a') :
+            {
+                stringstream ss(optarg);
+                if (!(ss >> shaBits) || ((1 != shaBits) &&
+                                         (224 != shaBits) &&
+                                         (256 != shaBits) &&
+                                         (384 != shaBits) &&
+                                         (512 != shaBits) &&
+                                         (512224 != shaBits) &&
+                                         (512256 != shaBits))) {
+                    cerr << "error: algorithm " << optarg << endl;
+                    exit(EXIT_FAILURE);
+                }
+            }
+            break;
+
+        case ('r') :
+            opt.useMmap = false;
+            break;
+
+        case ('c') :
+            checkMode = true;
+            break;
+
+        case ('j') :
+            {
+                stringstream ss(optarg);
+                if (!(ss >> opt.threads)) {
+                    cerr << "error: threads " << optarg << endl;
+                    exit(EXIT_FAILURE);
+                }
+            }
+            break;
+
+        case ('t') :
+            {
+                stringstream ss(optarg);
+                if (!(ss >> opt.treeChunk) || 0 == opt.treeChunk) {
+                    cerr << "error: chunk bytes " << optarg << endl;
+                    exit(EXIT_FAILURE);
+                }
+            }
+            break;
+
+        default :
+            printUsage(argv[0]);
+        }
+    }
+
+    vector<string> files(argv + optind, argv + argc);
+    if (files.empty()) files.push_back("-");
+
+    const bool result = checkMode
+        ? checkLoop(argv[0], shaBits, opt, files)
+        : printLoop(argv[0], shaBits, opt, files);
+
+    if (result)
+        return EXIT_SUCCESS;
+    else
+        exit(EXIT_FAILURE);
+}
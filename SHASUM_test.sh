@@ -0,0 +1,56 @@
+#!/bin/bash
+
+# Merkle tree roots (SHASUM -t) must not depend on how a file is read:
+# mapped, read() with -r, piped on standard input, one or many threads.
+# Roots of zero-filled files are checked against values computed with
+# Python hashlib.
+
+FAIL_COUNT=0
+
+TMP_DIR=`mktemp -d`
+trap "rm -rf $TMP_DIR" EXIT
+
+# checkRoot bytes chunk_bytes expected_root
+checkRoot() {
+    FILE=$TMP_DIR/zero$1
+    head -c $1 /dev/zero > $FILE
+
+    for HOW in "" "-r" "-j 4" "-r -j 4" "stdin"
+    do
+        if [ "$HOW" == "stdin" ]
+        then
+            MD=`cat $FILE | ./SHASUM -a 256 -t $2 | awk '{print $1}'`
+        else
+            MD=`./SHASUM -a 256 -t $2 $HOW $FILE | awk '{print $1}'`
+        fi
+
+        if [ "$MD" == "$3" ]
+        then
+            echo "OK "$1" bytes -t "$2" "$HOW
+        else
+            echo "FAIL "$1" bytes -t "$2" "$HOW
+            FAIL_COUNT=`expr $FAIL_COUNT + 1`
+        fi
+    done
+}
+
+# empty and single leaf
+checkRoot 0 1024 6e340b9cffb37a989ca544e6bb780a2c78901d3fb33738768511a30617afa01d
+checkRoot 1024 1024 c55b90509b8cb9bac53fbdddfc93d4e572685c509f1218423c43a5d6013bbd48
+checkRoot 1024 65536 c55b90509b8cb9bac53fbdddfc93d4e572685c509f1218423c43a5d6013bbd48
+
+# small enough for the multi-buffer batches, more than one leaf
+checkRoot 3000 1024 2f6ab88d8d1051ce8cb31d95f2d736c298082dde9705c0c89aa22ca5792e482a
+checkRoot 3000 65536 08ecd8dc245235d7704c15f4eae385b0d55a5d4040c4a9a1620e876165851aac
+
+# large file, leaves hashed as separate tasks when mapped
+checkRoot 300000 1024 1c8c87006ce6a779d01c6128831bb8e87a056f5bd195d5b37f56f2677874ff21
+checkRoot 300000 65536 47b6be1d87560f1661086fcf4944a49fc9cf3a1a31d61bb1e0797d183e7fd77a
+
+echo
+if [ $FAIL_COUNT == 0 ]
+then
+    echo All tests passed
+else
+    echo "There were "$FAIL_COUNT" failures"
+fi
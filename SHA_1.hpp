@@ -6,9 +6,72 @@
 
 #include <cryptl/BitwiseINT.hpp>
 #include <cryptl/SHA.hpp>
+#include <cryptl/SHA_Unrolled.hpp>
 
 namespace cryptl {
 
+////////////////////////////////////////////////////////////////////////////////
+// SHA-1 constant words
+//
+
+class SHA_1_IV
+{
+public:
+    typedef std::array<std::uint32_t, 5> ArrayType;
+
+    // initial hash value (NIST FIPS 180-4 section 5.3.1)
+    static const ArrayType& values() {
+        static constexpr ArrayType a {
+            0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0 };
+
+        return a;
+    }
+};
+
+class SHA_1_K
+{
+public:
+    typedef std::array<std::uint32_t, 4> ArrayType;
+
+    // constants (NIST FIPS 180-4 section 4.2.1), each used for 20 rounds
+    static const ArrayType& values() {
+        static constexpr ArrayType a {
+            0x5a827999, 0x6ed9eba1, 0x8f1bbcdc, 0xca62c1d6 };
+
+        return a;
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// fast compression for unmanaged 32-bit words, unrolled portable code
+//
+
+template <typename T, typename MSG, typename F>
+class SHA_1_Accel
+{
+public:
+    static bool enabled() { return false; }
+
+    static void compress(std::array<T, 5>&, const MSG*) {
+    }
+};
+
+template <>
+class SHA_1_Accel<std::uint32_t,
+                  std::uint32_t,
+                  SHA_Functions<std::uint32_t,
+                                std::uint32_t,
+                                BitwiseINT<std::uint32_t>>>
+{
+public:
+    static bool enabled() { return true; }
+
+    static void compress(std::array<std::uint32_t, 5>& H,
+                         const std::uint32_t* M) {
+        SHA_1_Unrolled::compress(H.data(), M, SHA_1_K::values().data());
+    }
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 // SHA-1
 //
@@ -24,30 +87,67 @@ public:
 
     typedef std::array<T, 16> MsgType;
     typedef std::array<T, 5> DigType;
+    typedef SHA_Midstate<T, 5> MidType;
     typedef std::array<U, 16 * 4> PreType;
 
-    SHA_1() {
-        initConstants();
-    }
-
     const std::array<T, 5>& digest() const {
         return m_H;
     }
 
+    // streamed hash value and message length, only at a block boundary
+    MidType midstate() const {
+        MidType a;
+        a.H = m_H;
+        a.lengthBits = this->streamLengthBits();
+        return a;
+    }
+
+    // continue streaming from a midstate instead of initHash()
+    void resumeHash(const MidType& a) {
+        m_H = a.H;
+        this->streamResume(a.lengthBits);
+    }
+
+    // only the intermediate hash value, see fork()
+    void forkHash(const SHA_1& other) {
+        m_H = other.m_H;
+    }
+
+    // chaining value of the full blocks in computeHashAppended()
+    void saveChain() {
+        m_chainH = m_H;
+    }
+
+    void restoreChain() {
+        m_H = m_chainH;
+    }
+
+    // see wipeHash()
+    void wipeState() {
+        wipeIfPlain(m_W);
+        wipeIfPlain(m_H);
+        wipeIfPlain(m_chainH);
+        wipeIfPlain(m_T);
+        wipeIfPlain(m_a);
+        wipeIfPlain(m_b);
+        wipeIfPlain(m_c);
+        wipeIfPlain(m_d);
+        wipeIfPlain(m_e);
+    }
+
     void initHashValue() {
         // set initial hash value (NIST FIPS 180-4 section 5.3.1)
-        const std::array<std::uint32_t, 5> a {
-            0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0 };
+        const auto& a = SHA_1_IV::values();
 
         for (std::size_t i = 0; i < 5; ++i) {
             m_H[i] = F::constant(a[i]);
         }
     }
 
-    void prepMsgSchedule(std::size_t& msgIndex) {
+    void prepMsgSchedule(MSG* M) {
         // prepare message schedule (NIST FIPS 180-4 section 6.1.2)
         for (std::size_t i = 0; i < 16; ++i) {
-            m_W[i] = this->msgWord(msgIndex);
+            m_W[i] = M[i];
         }
 
         for (std::size_t i = 16; i < 80; ++i) {
@@ -74,14 +174,14 @@ public:
     void workingLoop() {
         // inner loop (NIST FIPS 180-4 section 6.1.2)
         for (std::size_t i = 0; i < 80; ++i) {
-            //m_T = F::ROTL(m_a, 5) + F::f(m_b, m_c, m_d, i) + m_e + m_K[i] + m_W[i];
+            //m_T = F::ROTL(m_a, 5) + F::f(m_b, m_c, m_d, i) + m_e + m_K[i / 20] + m_W[i];
             m_T = F::ADDMOD(F::ADDMOD(
                                 F::ADDMOD(
                                     F::ADDMOD(
                                         F::ROTL(m_a, 5),
                                         F::f(m_b, m_c, m_d, i)),
                                     m_e),
-                                m_K[i]),
+                                m_K[i / 20]),
                             m_W[i]);
             m_e = m_d;
             m_d = m_c;
@@ -108,26 +208,25 @@ public:
     void afterHash() {
     }
 
-private:
-    void initConstants() {
-        // set constants (NIST FIPS 180-4 section 4.2.1)
-        for (std::size_t i = 0; i < 80; ++i) {
-            if (i < 20)
-                m_K[i] = F::constant(0x5a827999);
-            else if (i < 40)
-                m_K[i] = F::constant(0x6ed9eba1);
-            else if (i < 60)
-                m_K[i] = F::constant(0x8f1bbcdc);
-            else
-                m_K[i] = F::constant(0xca62c1d6);
+    // hides base class, fast compression for unmanaged words
+    void compressBlock(MSG* M) {
+        typedef SHA_1_Accel<T, MSG, F> Accel;
+
+        if (Accel::enabled()) {
+            Accel::compress(m_H, M);
+        } else {
+            SHA_Base<SHA_1<T, MSG, U, F>,
+                     SHA_BlockSize::BLOCK_512,
+                     MSG>::compressBlock(M);
         }
     }
 
+protected:
     // five 32-bit working variables
     T m_a, m_b, m_c, m_d, m_e;
 
-    // 80 constant 32-bit words
-    std::array<T, 80> m_K;
+    // four constant 32-bit words
+    SHA_Constants<T, F, SHA_1_K> m_K;
 
     // message schedule of 80 32-bit words
     std::array<T, 80> m_W;
@@ -135,6 +234,9 @@ private:
     // 160-bit hash value
     std::array<T, 5> m_H;
 
+    // hash value before the padding in computeHashAppended()
+    std::array<T, 5> m_chainH;
+
     // temporary word
     T m_T;
 };
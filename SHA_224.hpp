@@ -9,12 +9,31 @@
 
 namespace cryptl {
 
+////////////////////////////////////////////////////////////////////////////////
+// SHA-224 constant words
+//
+
+class SHA_224_IV
+{
+public:
+    typedef std::array<std::uint32_t, 8> ArrayType;
+
+    // initial hash value (NIST FIPS 180-4 section 5.3.2)
+    static const ArrayType& values() {
+        static constexpr ArrayType a {
+            0xc1059ed8, 0x367cd507, 0x3070dd17, 0xf70e5939,
+            0xffc00b31, 0x68581511, 0x64f98fa7, 0xbefa4fa4 };
+
+        return a;
+    }
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 // SHA-224
 //
 
 template <typename T, typename MSG, typename U, typename F>
-class SHA_224 : public SHA_256<T, MSG, U, F>
+class SHA_224 : public SHA_256<T, MSG, U, F, SHA_224<T, MSG, U, F>>
 {
 public:
     typedef T WordType;
@@ -42,18 +61,16 @@ public:
     }
 
     // overrides base class SHA-256
-    virtual void initHashValue() {
+    void initHashValue() {
         // set initial hash value (NIST FIPS 180-4 section 5.3.2)
-        const std::array<std::uint32_t, 8> a {
-            0xc1059ed8, 0x367cd507, 0x3070dd17, 0xf70e5939,
-            0xffc00b31, 0x68581511, 0x64f98fa7, 0xbefa4fa4 };
+        const auto& a = SHA_224_IV::values();
 
         for (std::size_t i = 0; i < 8; ++i) {
             this->m_H[i] = F::constant(a[i]);
         }
     }
 
-    virtual void afterHash() {
+    void afterHash() {
         m_setDigest = true;
     }
 
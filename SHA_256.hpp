@@ -6,15 +6,110 @@
 
 #include <cryptl/BitwiseINT.hpp>
 #include <cryptl/SHA.hpp>
+#include <cryptl/SHA_256_NI.hpp>
+#include <cryptl/SHA_Unrolled.hpp>
 
 namespace cryptl {
 
+////////////////////////////////////////////////////////////////////////////////
+// SHA-256 constant words
+//
+
+class SHA_256_IV
+{
+public:
+    typedef std::array<std::uint32_t, 8> ArrayType;
+
+    // initial hash value (NIST FIPS 180-4 section 5.3.3)
+    static const ArrayType& values() {
+        static constexpr ArrayType a {
+            0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+            0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19 };
+
+        return a;
+    }
+};
+
+class SHA_256_K
+{
+public:
+    typedef std::array<std::uint32_t, 64> ArrayType;
+
+    // constants (NIST FIPS 180-4 section 4.2.2)
+    static const ArrayType& values() {
+        static constexpr ArrayType a {
+            0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+            0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+
+            0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+            0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+
+            0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+            0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+
+            0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+            0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+
+            0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+            0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+
+            0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+            0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+
+            0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
+            0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+
+            0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+            0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2 };
+
+        return a;
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// fast compression for unmanaged 32-bit words: SHA extensions when the
+// processor has them, otherwise unrolled portable code
+//
+
+template <typename T, typename MSG, typename F>
+class SHA_256_Accel
+{
+public:
+    static bool enabled() { return false; }
+
+    static void compress(std::array<T, 8>&, const MSG*) {
+    }
+};
+
+template <>
+class SHA_256_Accel<std::uint32_t,
+                    std::uint32_t,
+                    SHA_Functions<std::uint32_t,
+                                  std::uint32_t,
+                                  BitwiseINT<std::uint32_t>>>
+{
+public:
+    static bool enabled() { return true; }
+
+    static void compress(std::array<std::uint32_t, 8>& H,
+                         const std::uint32_t* M) {
+        if (SHA_256_NI::available())
+            SHA_256_NI::compress(H.data(), M, SHA_256_K::values().data());
+        else
+            SHA_256_Unrolled::compress(H.data(), M, SHA_256_K::values().data());
+    }
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 // SHA-256
 //
 
-template <typename T, typename MSG, typename U, typename F>
-class SHA_256 : public SHA_Base<SHA_256<T, MSG, U, F>,
+template <typename T,
+          typename MSG,
+          typename U,
+          typename F,
+          typename DERIVED = void>
+class SHA_256 : public SHA_Base<SHA_CRTP<SHA_256<T, MSG, U, F>, DERIVED>,
                                 SHA_BlockSize::BLOCK_512,
                                 MSG>
 {
@@ -24,31 +119,70 @@ public:
 
     typedef std::array<T, 16> MsgType;
     typedef std::array<T, 8> DigType;
+    typedef SHA_Midstate<T, 8> MidType;
     typedef std::array<U, 16 * 4> PreType;
 
-    SHA_256() {
-        initConstants();
-    }
-
     const std::array<T, 8>& digest() const {
         return m_H;
     }
 
-    virtual void initHashValue() {
+    // streamed hash value and message length, only at a block boundary
+    MidType midstate() const {
+        MidType a;
+        a.H = m_H;
+        a.lengthBits = this->streamLengthBits();
+        return a;
+    }
+
+    // continue streaming from a midstate instead of initHash()
+    void resumeHash(const MidType& a) {
+        m_H = a.H;
+        this->streamResume(a.lengthBits);
+    }
+
+    // only the intermediate hash value, see fork()
+    void forkHash(const SHA_256& other) {
+        m_H = other.m_H;
+    }
+
+    // chaining value of the full blocks in computeHashAppended()
+    void saveChain() {
+        m_chainH = m_H;
+    }
+
+    void restoreChain() {
+        m_H = m_chainH;
+    }
+
+    // see wipeHash()
+    void wipeState() {
+        wipeIfPlain(m_W);
+        wipeIfPlain(m_H);
+        wipeIfPlain(m_chainH);
+        wipeIfPlain(m_T);
+        wipeIfPlain(m_a);
+        wipeIfPlain(m_b);
+        wipeIfPlain(m_c);
+        wipeIfPlain(m_d);
+        wipeIfPlain(m_e);
+        wipeIfPlain(m_f);
+        wipeIfPlain(m_g);
+        wipeIfPlain(m_h);
+    }
+
+    void initHashValue() {
         // set initial hash value (NIST FIPS 180-4 section 5.3.3)
-        const std::array<std::uint32_t, 8> a {
-            0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
-            0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19 };
+        const auto& a = SHA_256_IV::values();
 
         for (std::size_t i = 0; i < 8; ++i) {
             m_H[i] = F::constant(a[i]);
         }
     }
 
-    void prepMsgSchedule(std::size_t& msgIndex) {
+    void prepMsgSchedule(MSG* M) {
         // prepare message schedule (NIST FIPS 180-4 section 6.2.2)
         for (std::size_t i = 0; i < 16; ++i) {
-            m_W[i] = this->msgWord(msgIndex);
+            m_W[i] = M[i];
         }
 
         for (std::size_t i = 16; i < 64; ++i) {
@@ -121,47 +255,28 @@ public:
         m_H[7] = F::ADDMOD(m_H[7], m_h);
     }
 
-    virtual void afterHash() {
+    void afterHash() {
     }
 
-protected:
-    void initConstants() {
-        // set constants (NIST FIPS 180-4 section 4.2.2)
-        const std::array<std::uint32_t, 64> a {
-            0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
-            0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    // hides base class, fast compression for unmanaged words
+    void compressBlock(MSG* M) {
+        typedef SHA_256_Accel<T, MSG, F> Accel;
 
-            0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
-            0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
-
-            0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
-            0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
-
-            0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
-            0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
-
-            0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
-            0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
-
-            0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
-            0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
-
-            0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
-            0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
-
-            0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
-            0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2 };
-
-        for (std::size_t i = 0; i < 64; ++i) {
-            m_K[i] = F::constant(a[i]);
+        if (Accel::enabled()) {
+            Accel::compress(m_H, M);
+        } else {
+            SHA_Base<SHA_CRTP<SHA_256<T, MSG, U, F>, DERIVED>,
+                     SHA_BlockSize::BLOCK_512,
+                     MSG>::compressBlock(M);
         }
     }
 
+protected:
     // eight 32-bit working variables
     T m_a, m_b, m_c, m_d, m_e, m_f, m_g, m_h;
 
     // 64 constant 32-bit words
-    std::array<T, 64> m_K;
+    SHA_Constants<T, F, SHA_256_K> m_K;
 
     // message schedule of 64 32-bit words
     std::array<T, 64> m_W;
@@ -169,6 +284,9 @@ protected:
     // 256-bit hash value
     std::array<T, 8> m_H;
 
+    // hash value before the padding in computeHashAppended()
+    std::array<T, 8> m_chainH;
+
     // two temporary words
     std::array<T, 2> m_T;
 };
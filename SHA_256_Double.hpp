@@ -0,0 +1,208 @@
+#ifndef _CRYPTL_SHA_256_DOUBLE_HPP_
+#define _CRYPTL_SHA_256_DOUBLE_HPP_
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include <cryptl/BitwiseINT.hpp>
+#include <cryptl/SHA.hpp>
+#include <cryptl/SHA_256.hpp>
+#include <cryptl/SHA_256_MultiBuffer.hpp>
+#include <cryptl/SHA_256_NI.hpp>
+#include <cryptl/SHA_Stream.hpp>
+
+namespace cryptl {
+
+////////////////////////////////////////////////////////////////////////////////
+// SHA-256 padding of a 32-byte message
+//
+
+class SHA_256_Pad32
+{
+public:
+    typedef std::array<std::uint32_t, 8> ArrayType;
+
+    // message words 8 to 15: bit "1", zero bits, length of 256 bits
+    static const ArrayType& values() {
+        static constexpr ArrayType a {
+            0x80000000, 0x00000000, 0x00000000, 0x00000000,
+            0x00000000, 0x00000000, 0x00000000, 0x00000100 };
+
+        return a;
+    }
+};
+
+class SHA_256_Pad32KW
+{
+public:
+    typedef std::array<std::uint32_t, 8> ArrayType;
+
+    // K[i] + W[i] for rounds 8 to 15
+    static const ArrayType& values() {
+        static constexpr ArrayType a {
+            0x5807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+            0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf274 };
+
+        return a;
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// double SHA-256, i.e. SHA-256(SHA-256(x))
+//
+// The first digest goes into the second compression as message words, it
+// is never serialized to bytes. The second message is always 32 bytes so it
+// is a single block with a constant second half.
+//
+// Only the portable second pass uses SHA_256_Pad32KW. SHA-NI and the SIMD
+// lanes add K and W for four rounds or for all lanes in one instruction,
+// and still need words 8 to 15 for the rest of the schedule, so they take
+// the padded block as it is.
+//
+
+class SHA_256_Double
+{
+public:
+    typedef SHA256::DigType DigType;
+
+    static DigType hash(const std::uint8_t* p, const std::size_t n) {
+        SHA_Stream<SHA256> hashStream;
+        hashStream.update(p, n);
+        return hashDigest(hashStream.final());
+    }
+
+    static DigType hash(const std::vector<std::uint8_t>& a) {
+        return hash(a.data(), a.size());
+    }
+
+    // second pass only, SHA-256 of the 32 bytes of a digest
+    static DigType hashDigest(const DigType& D) {
+        DigType H = SHA_256_IV::values();
+
+        if (SHA_256_NI::available()) {
+            std::array<std::uint32_t, 16> M;
+            for (std::size_t i = 0; i < 8; ++i) {
+                M[i] = D[i];
+                M[i + 8] = SHA_256_Pad32::values()[i];
+            }
+
+            SHA_256_NI::compress(H.data(), M.data(), SHA_256_K::values().data());
+        } else {
+            compressDigest(H.data(), D.data());
+        }
+
+        return H;
+    }
+
+    // batch of messages, first pass in multi-buffer lanes
+    static void hash(const std::uint8_t* const* msg,
+                     const std::size_t* len,
+                     const std::size_t N,
+                     DigType* out)
+    {
+        SHA256_MultiBuffer().digest(msg, len, N, out);
+        hashDigest(out, N, out);
+    }
+
+    static std::vector<DigType> hash(const std::vector<std::vector<std::uint8_t>>& a) {
+        std::vector<DigType> out = SHA256_MultiBuffer().digest(a);
+        hashDigest(out.data(), out.size(), out.data());
+        return out;
+    }
+
+    // batch of second passes, out may be the same as D
+    static void hashDigest(const DigType* D, const std::size_t N, DigType* out) {
+        const std::size_t L = SHA_256_Lanes::lanes();
+
+        std::size_t i = 0;
+        if (0 != L) {
+            for (; i + L <= N; i += L) hashLanes(L, D + i, out + i);
+        }
+
+        for (; i < N; ++i) out[i] = hashDigest(D[i]);
+    }
+
+private:
+    // one block, message words 0 to 7 are D and the rest are constant
+    static void compressDigest(std::uint32_t* H, const std::uint32_t* D) {
+        typedef SHA_Functions<std::uint32_t,
+                              std::uint32_t,
+                              BitwiseINT<std::uint32_t>> F;
+
+        const auto& K = SHA_256_K::values();
+        const auto& KW = SHA_256_Pad32KW::values();
+
+        std::uint32_t a = H[0], b = H[1], c = H[2], d = H[3],
+                      e = H[4], f = H[5], g = H[6], h = H[7];
+
+        std::uint32_t W[16];
+        for (std::size_t i = 0; i < 8; ++i) {
+            W[i] = D[i];
+            W[i + 8] = SHA_256_Pad32::values()[i];
+        }
+
+        // (NIST FIPS 180-4 section 6.2.2)
+#pragma GCC unroll 64
+        for (std::size_t i = 0; i < 64; ++i) {
+            if (i >= 16) {
+                W[i % 16] += F::sigma_256_1(W[(i - 2) % 16]) + W[(i - 7) % 16] +
+                             F::sigma_256_0(W[(i - 15) % 16]);
+            }
+
+            const std::uint32_t
+                T1 = h + F::SIGMA_256_1(e) + F::Ch(e, f, g) +
+                     (i >= 8 && i < 16 ? KW[i - 8] : K[i] + W[i % 16]),
+                T2 = F::SIGMA_256_0(a) + F::Maj(a, b, c);
+
+            h = g;
+            g = f;
+            f = e;
+            e = d + T1;
+            d = c;
+            c = b;
+            b = a;
+            a = T1 + T2;
+        }
+
+        H[0] += a;
+        H[1] += b;
+        H[2] += c;
+        H[3] += d;
+        H[4] += e;
+        H[5] += f;
+        H[6] += g;
+        H[7] += h;
+    }
+
+    // L second passes at once, lane state is word-major as in SHA_MultiBuffer
+    static void hashLanes(const std::size_t L, const DigType* D, DigType* out) {
+        static const std::size_t MAX_LANES = SHA_256_Lanes::MAX_LANES;
+
+        alignas(64) std::array<std::uint32_t, 8 * MAX_LANES> H;
+        alignas(64) std::array<std::uint32_t, 16 * MAX_LANES> W;
+
+        const auto& IV = SHA_256_IV::values();
+        const auto& pad = SHA_256_Pad32::values();
+
+        for (std::size_t j = 0; j < L; ++j) {
+            for (std::size_t i = 0; i < 8; ++i) {
+                H[i * L + j] = IV[i];
+                W[i * L + j] = D[j][i];
+                W[(i + 8) * L + j] = pad[i];
+            }
+        }
+
+        SHA_256_Lanes::compress(L, H.data(), W.data(), SHA_256_K::values().data());
+
+        for (std::size_t j = 0; j < L; ++j) {
+            for (std::size_t i = 0; i < 8; ++i) {
+                out[j][i] = H[i * L + j];
+            }
+        }
+    }
+};
+
+} // namespace cryptl
+
+#endif
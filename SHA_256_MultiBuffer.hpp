@@ -0,0 +1,239 @@
+#ifndef _CRYPTL_SHA_256_MULTI_BUFFER_HPP_
+#define _CRYPTL_SHA_256_MULTI_BUFFER_HPP_
+
+#include <cstdint>
+
+#include <cryptl/CPU_Features.hpp>
+#include <cryptl/SHA_224.hpp>
+#include <cryptl/SHA_256.hpp>
+#include <cryptl/SHA_MultiBuffer.hpp>
+
+#ifdef CRYPTL_X86_64
+#include <immintrin.h>
+#endif
+
+namespace cryptl {
+
+////////////////////////////////////////////////////////////////////////////////
+// SHA-256 compression of 8 (AVX2) or 16 (AVX-512) messages at once
+//
+// H is 8 words by L lanes, W is 16 words by L lanes, K is the 64 round
+// constants. Lane j of word i is at index i * L + j.
+//
+
+class SHA_256_Lanes
+{
+public:
+    static const std::size_t MAX_LANES = 16;
+
+    // zero if there are no suitable SIMD extensions
+    static std::size_t lanes() {
+        return CPU_Features::hasAVX512() ? 16 : CPU_Features::hasAVX2() ? 8 : 0;
+    }
+
+#ifdef CRYPTL_X86_64
+    static void compress(const std::size_t L,
+                         std::uint32_t* H,
+                         const std::uint32_t* W,
+                         const std::uint32_t* K) {
+        if (16 == L)
+            compress16<false>(H, W, K);
+        else
+            compress8<false>(H, W, K);
+    }
+
+    // no message, KW is the round constants plus the message schedule of
+    // a block known in advance (e.g. padding only)
+    static void compressScheduled(const std::size_t L,
+                                  std::uint32_t* H,
+                                  const std::uint32_t* KW) {
+        if (16 == L)
+            compress16<true>(H, nullptr, KW);
+        else
+            compress8<true>(H, nullptr, KW);
+    }
+#else
+    static void compress(const std::size_t,
+                         std::uint32_t*,
+                         const std::uint32_t*,
+                         const std::uint32_t*) {
+    }
+
+    static void compressScheduled(const std::size_t,
+                                  std::uint32_t*,
+                                  const std::uint32_t*) {
+    }
+#endif
+
+#ifdef CRYPTL_X86_64
+private:
+    // AVX2, eight lanes
+    __attribute__((target("avx2")))
+    static __m256i ROTR(const __m256i x, const int n) {
+        return _mm256_or_si256(_mm256_srli_epi32(x, n), _mm256_slli_epi32(x, 32 - n));
+    }
+
+    __attribute__((target("avx2")))
+    static __m256i XOR3(const __m256i x, const __m256i y, const __m256i z) {
+        return _mm256_xor_si256(_mm256_xor_si256(x, y), z);
+    }
+
+    template <bool SCHEDULED>
+    __attribute__((target("avx2")))
+    static void compress8(std::uint32_t* H,
+                          const std::uint32_t* M,
+                          const std::uint32_t* K)
+    {
+        __m256i V[8];
+        for (std::size_t i = 0; i < 8; ++i)
+            V[i] = _mm256_load_si256(reinterpret_cast<const __m256i*>(H + 8*i));
+
+        __m256i a = V[0], b = V[1], c = V[2], d = V[3],
+                e = V[4], f = V[5], g = V[6], h = V[7];
+
+        // message schedule in a rolling window of sixteen words, unused when
+        // KW already has it
+        __m256i W[16];
+
+#pragma GCC unroll 64
+        for (std::size_t i = 0; i < 64; ++i) {
+            __m256i KW;
+            if (SCHEDULED) {
+                KW = _mm256_set1_epi32(K[i]);
+            } else {
+                if (i < 16) {
+                    W[i] = _mm256_load_si256(reinterpret_cast<const __m256i*>(M + 8*i));
+                } else {
+                    const __m256i w2 = W[(i - 2) % 16], w15 = W[(i - 15) % 16];
+                    const __m256i s1 = XOR3(ROTR(w2, 17), ROTR(w2, 19), _mm256_srli_epi32(w2, 10));
+                    const __m256i s0 = XOR3(ROTR(w15, 7), ROTR(w15, 18), _mm256_srli_epi32(w15, 3));
+                    W[i % 16] = _mm256_add_epi32(
+                        _mm256_add_epi32(s1, W[(i - 7) % 16]),
+                        _mm256_add_epi32(s0, W[i % 16]));
+                }
+
+                KW = _mm256_add_epi32(_mm256_set1_epi32(K[i]), W[i % 16]);
+            }
+
+            // T1 = h + SIGMA_256_1(e) + Ch(e, f, g) + K[i] + W[i]
+            const __m256i ch = _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g));
+            const __m256i T1 = _mm256_add_epi32(
+                _mm256_add_epi32(h, XOR3(ROTR(e, 6), ROTR(e, 11), ROTR(e, 25))),
+                _mm256_add_epi32(ch, KW));
+
+            // T2 = SIGMA_256_0(a) + Maj(a, b, c)
+            const __m256i maj = XOR3(_mm256_and_si256(a, b), _mm256_and_si256(a, c), _mm256_and_si256(b, c));
+            const __m256i T2 = _mm256_add_epi32(XOR3(ROTR(a, 2), ROTR(a, 13), ROTR(a, 22)), maj);
+
+            h = g;
+            g = f;
+            f = e;
+            e = _mm256_add_epi32(d, T1);
+            d = c;
+            c = b;
+            b = a;
+            a = _mm256_add_epi32(T1, T2);
+        }
+
+        V[0] = _mm256_add_epi32(V[0], a);
+        V[1] = _mm256_add_epi32(V[1], b);
+        V[2] = _mm256_add_epi32(V[2], c);
+        V[3] = _mm256_add_epi32(V[3], d);
+        V[4] = _mm256_add_epi32(V[4], e);
+        V[5] = _mm256_add_epi32(V[5], f);
+        V[6] = _mm256_add_epi32(V[6], g);
+        V[7] = _mm256_add_epi32(V[7], h);
+
+        for (std::size_t i = 0; i < 8; ++i)
+            _mm256_store_si256(reinterpret_cast<__m256i*>(H + 8*i), V[i]);
+    }
+
+    // AVX-512, sixteen lanes
+    __attribute__((target("avx512f")))
+    static __m512i XOR3(const __m512i x, const __m512i y, const __m512i z) {
+        return _mm512_ternarylogic_epi32(x, y, z, 0x96);
+    }
+
+    template <bool SCHEDULED>
+    __attribute__((target("avx512f")))
+    static void compress16(std::uint32_t* H,
+                           const std::uint32_t* M,
+                           const std::uint32_t* K)
+    {
+        __m512i V[8];
+        for (std::size_t i = 0; i < 8; ++i)
+            V[i] = _mm512_load_si512(H + 16*i);
+
+        __m512i a = V[0], b = V[1], c = V[2], d = V[3],
+                e = V[4], f = V[5], g = V[6], h = V[7];
+
+        // message schedule in a rolling window of sixteen words, unused when
+        // KW already has it
+        __m512i W[16];
+
+#pragma GCC unroll 64
+        for (std::size_t i = 0; i < 64; ++i) {
+            __m512i KW;
+            if (SCHEDULED) {
+                KW = _mm512_set1_epi32(K[i]);
+            } else {
+                if (i < 16) {
+                    W[i] = _mm512_load_si512(M + 16*i);
+                } else {
+                    const __m512i w2 = W[(i - 2) % 16], w15 = W[(i - 15) % 16];
+                    const __m512i s1 = XOR3(_mm512_ror_epi32(w2, 17), _mm512_ror_epi32(w2, 19), _mm512_srli_epi32(w2, 10));
+                    const __m512i s0 = XOR3(_mm512_ror_epi32(w15, 7), _mm512_ror_epi32(w15, 18), _mm512_srli_epi32(w15, 3));
+                    W[i % 16] = _mm512_add_epi32(
+                        _mm512_add_epi32(s1, W[(i - 7) % 16]),
+                        _mm512_add_epi32(s0, W[i % 16]));
+                }
+
+                KW = _mm512_add_epi32(_mm512_set1_epi32(K[i]), W[i % 16]);
+            }
+
+            // T1 = h + SIGMA_256_1(e) + Ch(e, f, g) + K[i] + W[i]
+            const __m512i ch = _mm512_ternarylogic_epi32(e, f, g, 0xca);
+            const __m512i T1 = _mm512_add_epi32(
+                _mm512_add_epi32(h, XOR3(_mm512_ror_epi32(e, 6), _mm512_ror_epi32(e, 11), _mm512_ror_epi32(e, 25))),
+                _mm512_add_epi32(ch, KW));
+
+            // T2 = SIGMA_256_0(a) + Maj(a, b, c)
+            const __m512i maj = _mm512_ternarylogic_epi32(a, b, c, 0xe8);
+            const __m512i T2 = _mm512_add_epi32(XOR3(_mm512_ror_epi32(a, 2), _mm512_ror_epi32(a, 13), _mm512_ror_epi32(a, 22)), maj);
+
+            h = g;
+            g = f;
+            f = e;
+            e = _mm512_add_epi32(d, T1);
+            d = c;
+            c = b;
+            b = a;
+            a = _mm512_add_epi32(T1, T2);
+        }
+
+        V[0] = _mm512_add_epi32(V[0], a);
+        V[1] = _mm512_add_epi32(V[1], b);
+        V[2] = _mm512_add_epi32(V[2], c);
+        V[3] = _mm512_add_epi32(V[3], d);
+        V[4] = _mm512_add_epi32(V[4], e);
+        V[5] = _mm512_add_epi32(V[5], f);
+        V[6] = _mm512_add_epi32(V[6], g);
+        V[7] = _mm512_add_epi32(V[7], h);
+
+        for (std::size_t i = 0; i < 8; ++i)
+            _mm512_store_si512(H + 16*i, V[i]);
+    }
+#endif
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// typedefs
+//
+
+typedef SHA_MultiBuffer<SHA256, SHA_256_Lanes> SHA256_MultiBuffer;
+
+typedef SHA_MultiBuffer<SHA224, SHA_256_Lanes> SHA224_MultiBuffer;
+
+} // namespace cryptl
+
+#endif
@@ -0,0 +1,134 @@
+#ifndef _CRYPTL_SHA_256_NI_HPP_
+#define _CRYPTL_SHA_256_NI_HPP_
+
+#include <cstdint>
+
+#include <cryptl/CPU_Features.hpp>
+
+#ifdef CRYPTL_X86_64
+#include <immintrin.h>
+#endif
+
+namespace cryptl {
+
+////////////////////////////////////////////////////////////////////////////////
+// SHA-256 compression with the x86 SHA extensions
+//
+// H is the eight word hash value, M is one block of sixteen message words
+// (already big-endian decoded), K is the sixty-four round constants.
+//
+
+class SHA_256_NI
+{
+public:
+    static bool available() {
+        return CPU_Features::hasSHA();
+    }
+
+#ifdef CRYPTL_X86_64
+    __attribute__((target("sha,sse4.1")))
+    static void compress(std::uint32_t* H,
+                         const std::uint32_t* M,
+                         const std::uint32_t* K)
+    {
+        // hash value as ABEF and CDGH
+        __m128i tmp = _mm_loadu_si128(reinterpret_cast<const __m128i*>(H));
+        __m128i state1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(H + 4));
+        tmp = _mm_shuffle_epi32(tmp, 0xb1);          // CDAB
+        state1 = _mm_shuffle_epi32(state1, 0x1b);    // EFGH
+        __m128i state0 = _mm_alignr_epi8(tmp, state1, 8); // ABEF
+        state1 = _mm_blend_epi16(state1, tmp, 0xf0); // CDGH
+
+        const __m128i saveABEF = state0, saveCDGH = state1;
+
+        // message schedule, four words per register in a rolling window
+        __m128i W[4];
+
+        // sixteen groups of four rounds
+#pragma GCC unroll 16
+        for (std::size_t g = 0; g < 16; ++g) {
+            if (g < 4) {
+                W[g] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(M + 4*g));
+            }
+
+            __m128i msg = _mm_add_epi32(
+                W[g % 4],
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(K + 4*g)));
+
+            state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+
+            if (g >= 3 && g < 15) {
+                __m128i& next = W[(g + 1) % 4];
+                next = _mm_add_epi32(next, _mm_alignr_epi8(W[g % 4], W[(g + 3) % 4], 4));
+                next = _mm_sha256msg2_epu32(next, W[g % 4]);
+            }
+
+            msg = _mm_shuffle_epi32(msg, 0x0e);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, msg);
+
+            if (g >= 1 && g < 13) {
+                __m128i& prev = W[(g + 3) % 4];
+                prev = _mm_sha256msg1_epu32(prev, W[g % 4]);
+            }
+        }
+
+        state0 = _mm_add_epi32(state0, saveABEF);
+        state1 = _mm_add_epi32(state1, saveCDGH);
+
+        // ABEF and CDGH back to hash value
+        tmp = _mm_shuffle_epi32(state0, 0x1b);       // FEBA
+        state1 = _mm_shuffle_epi32(state1, 0xb1);    // DCHG
+        state0 = _mm_blend_epi16(tmp, state1, 0xf0); // DCBA
+        state1 = _mm_alignr_epi8(state1, tmp, 8);    // HGFE
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(H), state0);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(H + 4), state1);
+    }
+
+    // no message, KW is the round constants plus the message schedule of
+    // a block known in advance (e.g. padding only)
+    __attribute__((target("sha,sse4.1")))
+    static void compressScheduled(std::uint32_t* H, const std::uint32_t* KW)
+    {
+        __m128i tmp = _mm_loadu_si128(reinterpret_cast<const __m128i*>(H));
+        __m128i state1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(H + 4));
+        tmp = _mm_shuffle_epi32(tmp, 0xb1);
+        state1 = _mm_shuffle_epi32(state1, 0x1b);
+        __m128i state0 = _mm_alignr_epi8(tmp, state1, 8);
+        state1 = _mm_blend_epi16(state1, tmp, 0xf0);
+
+        const __m128i saveABEF = state0, saveCDGH = state1;
+
+#pragma GCC unroll 16
+        for (std::size_t g = 0; g < 16; ++g) {
+            __m128i msg = _mm_loadu_si128(reinterpret_cast<const __m128i*>(KW + 4*g));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+            msg = _mm_shuffle_epi32(msg, 0x0e);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, msg);
+        }
+
+        state0 = _mm_add_epi32(state0, saveABEF);
+        state1 = _mm_add_epi32(state1, saveCDGH);
+
+        tmp = _mm_shuffle_epi32(state0, 0x1b);
+        state1 = _mm_shuffle_epi32(state1, 0xb1);
+        state0 = _mm_blend_epi16(tmp, state1, 0xf0);
+        state1 = _mm_alignr_epi8(state1, tmp, 8);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(H), state0);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(H + 4), state1);
+    }
+#else
+    static void compress(std::uint32_t*,
+                         const std::uint32_t*,
+                         const std::uint32_t*) {
+    }
+
+    static void compressScheduled(std::uint32_t*, const std::uint32_t*) {
+    }
+#endif
+};
+
+} // namespace cryptl
+
+#endif
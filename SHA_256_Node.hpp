@@ -0,0 +1,279 @@
+#ifndef _CRYPTL_SHA_256_NODE_HPP_
+#define _CRYPTL_SHA_256_NODE_HPP_
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include <cryptl/Bless.hpp>
+#include <cryptl/SHA_256.hpp>
+#include <cryptl/SHA_256_MultiBuffer.hpp>
+#include <cryptl/SHA_256_NI.hpp>
+#include <cryptl/SHA_Unrolled.hpp>
+
+namespace cryptl {
+
+////////////////////////////////////////////////////////////////////////////////
+// SHA-256 padding block of a message of BYTES (64 or 128)
+//
+
+template <std::size_t BYTES>
+class SHA_256_PadKW;
+
+template <>
+class SHA_256_PadKW<64>
+{
+public:
+    typedef std::array<std::uint32_t, 64> ArrayType;
+
+    // K[i] + W[i] where W is the message schedule of the block
+    // 0x80000000, 0, ..., 0, 512 (bit "1", zero bits, length of 512 bits)
+    static const ArrayType& values() {
+        static constexpr ArrayType a {
+            0xc28a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+            0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+
+            0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+            0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf374,
+
+            0x649b69c1, 0xf0fe4786, 0x0fe1edc6, 0x240cf254,
+            0x4fe9346f, 0x6cc984be, 0x61b9411e, 0x16f988fa,
+
+            0xf2c65152, 0xa88e5a6d, 0xb019fc65, 0xb9d99ec7,
+            0x9a1231c3, 0xe70eeaa0, 0xfdb1232b, 0xc7353eb0,
+
+            0x3069bad5, 0xcb976d5f, 0x5a0f118f, 0xdc1eeefd,
+            0x0a35b689, 0xde0b7a04, 0x58f4ca9d, 0xe15d5b16,
+
+            0x007f3e86, 0x37088980, 0xa507ea32, 0x6fab9537,
+            0x17406110, 0x0d8cd6f1, 0xcdaa3b6d, 0xc0bbbe37,
+
+            0x83613bda, 0xdb48a363, 0x0b02e931, 0x6fd15ca7,
+            0x521afaca, 0x31338431, 0x6ed41a95, 0x6d437890,
+
+            0xc39c91f2, 0x9eccabbd, 0xb5c9a0e6, 0x532fb63c,
+            0xd2c741c6, 0x07237ea3, 0xa4954b68, 0x4c191d76 };
+
+        return a;
+    }
+};
+
+template <>
+class SHA_256_PadKW<128>
+{
+public:
+    typedef std::array<std::uint32_t, 64> ArrayType;
+
+    // K[i] + W[i] where W is the message schedule of the block
+    // 0x80000000, 0, ..., 0, 1024 (bit "1", zero bits, length of 1024 bits)
+    static const ArrayType& values() {
+        static constexpr ArrayType a {
+            0xc28a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+            0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+
+            0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+            0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf574,
+
+            0x649b69c1, 0xf23e4787, 0x0fe1edc6, 0x240ca2dc,
+            0x4fe9346f, 0x4b1e84aa, 0x61b9431e, 0x36f9b39a,
+
+            0xfa465156, 0xb85a8e77, 0xb01d681d, 0x5e59c7ea,
+            0x2faa3291, 0x07e2a6fb, 0x1f515a8e, 0x6f915f0a,
+
+            0x5fb4221d, 0x612cc90a, 0x35c3e883, 0xa925d9d4,
+            0x8b82d1b9, 0x92848088, 0x9a5b7704, 0x034ba272,
+
+            0x9f594686, 0x6f480592, 0xe49bee62, 0xc1cf12eb,
+            0x3ef55e11, 0x1f0f59a3, 0x327a0634, 0xbfa4d9bc,
+
+            0x770df572, 0x9b9fbf40, 0xc21be9e9, 0xf5001d69,
+            0x840ec6da, 0x8a337f83, 0xb737625a, 0xe9b9ecd0,
+
+            0xfe5d6d40, 0xa52dab8d, 0xee944592, 0x5f2d004a,
+            0x3bc8cb2e, 0x36d964a4, 0x5eb10caf, 0x6289d971 };
+
+        return a;
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// SHA-256 hash value after the Merkle node block
+//
+// The block is 0x01 followed by 63 zero bytes. Interior nodes start from
+// here instead of the standard initial hash value, so a node is never the
+// hash of anything that does not begin with that block.
+//
+
+class SHA_256_NodeIV
+{
+public:
+    typedef std::array<std::uint32_t, 8> ArrayType;
+
+    static const ArrayType& values() {
+        static constexpr ArrayType a {
+            0xe3050856, 0xaac38966, 0x1ae49065, 0x6ad0ea57,
+            0xdf6aff0f, 0xf6eef306, 0xf8cc2eed, 0x4f240249 };
+
+        return a;
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// two-to-one SHA-256 for Merkle tree nodes
+//
+// One 64-byte message block, the digests of two children. The block after
+// it is only padding, so its message schedule is a table and the second
+// compression is rounds alone, with SHA-NI, in SIMD lanes or portable.
+//
+// hash() is SHA-256 of left || right. node() is the Merkle interior node,
+// SHA-256 of the node block (see SHA_256_NodeIV) || left || right. It costs
+// the same as hash(), the node block is already in its initial value.
+//
+// A whole tree level is hashed in SIMD lanes when that is faster than one
+// node at a time.
+//
+
+class SHA_256_Node
+{
+public:
+    typedef SHA256::DigType DigType;
+
+    // SHA-256 of left || right
+    static DigType hash(const DigType& left, const DigType& right) {
+        return hashPair<false>(left, right);
+    }
+
+    // SHA-256 of 64 bytes
+    static DigType hash(const std::uint8_t* p) {
+        std::array<std::uint32_t, 16> M;
+        for (std::size_t i = 0; i < 16; ++i) {
+            blessBigEndian(M[i], p + 4 * i);
+        }
+
+        return hashBlock<false>(M.data());
+    }
+
+    // one tree level: parent[i] = hash(child[2i], child[2i + 1]) for i < N
+    static void hash(const DigType* child, const std::size_t N, DigType* parent) {
+        hashLevel<false>(child, N, parent);
+    }
+
+    // next level up, an odd node at the end moves up unchanged
+    static std::vector<DigType> hash(const std::vector<DigType>& level) {
+        return hashLevel<false>(level);
+    }
+
+    // Merkle interior node
+    static DigType node(const DigType& left, const DigType& right) {
+        return hashPair<true>(left, right);
+    }
+
+    static void node(const DigType* child, const std::size_t N, DigType* parent) {
+        hashLevel<true>(child, N, parent);
+    }
+
+    static std::vector<DigType> node(const std::vector<DigType>& level) {
+        return hashLevel<true>(level);
+    }
+
+private:
+    // initial value and second block of either kind
+    template <bool NODE>
+    static const SHA_256_IV::ArrayType& IV() {
+        return NODE ? SHA_256_NodeIV::values() : SHA_256_IV::values();
+    }
+
+    template <bool NODE>
+    static const std::uint32_t* padKW() {
+        return NODE
+            ? SHA_256_PadKW<128>::values().data()
+            : SHA_256_PadKW<64>::values().data();
+    }
+
+    template <bool NODE>
+    static DigType hashPair(const DigType& left, const DigType& right) {
+        std::array<std::uint32_t, 16> M;
+        for (std::size_t i = 0; i < 8; ++i) {
+            M[i] = left[i];
+            M[i + 8] = right[i];
+        }
+
+        return hashBlock<NODE>(M.data());
+    }
+
+    template <bool NODE>
+    static DigType hashBlock(const std::uint32_t* M) {
+        const auto& K = SHA_256_K::values();
+
+        DigType H = IV<NODE>();
+
+        if (SHA_256_NI::available()) {
+            SHA_256_NI::compress(H.data(), M, K.data());
+            SHA_256_NI::compressScheduled(H.data(), padKW<NODE>());
+        } else {
+            SHA_256_Unrolled::compress(H.data(), M, K.data());
+            SHA_256_Unrolled::compressScheduled(H.data(), padKW<NODE>());
+        }
+
+        return H;
+    }
+
+    template <bool NODE>
+    static void hashLevel(const DigType* child, const std::size_t N, DigType* parent) {
+        // SHA-NI one node at a time is faster than eight AVX2 lanes
+        const std::size_t L =
+            SHA_256_NI::available() && 16 != SHA_256_Lanes::lanes()
+                ? 0
+                : SHA_256_Lanes::lanes();
+
+        std::size_t i = 0;
+        if (0 != L) {
+            for (; i + L <= N; i += L) hashLanes<NODE>(L, child + 2 * i, parent + i);
+        }
+
+        for (; i < N; ++i) parent[i] = hashPair<NODE>(child[2 * i], child[2 * i + 1]);
+    }
+
+    template <bool NODE>
+    static std::vector<DigType> hashLevel(const std::vector<DigType>& level) {
+        const std::size_t N = level.size() / 2;
+
+        std::vector<DigType> up(N + level.size() % 2);
+        hashLevel<NODE>(level.data(), N, up.data());
+        if (level.size() % 2) up.back() = level.back();
+
+        return up;
+    }
+
+    // L nodes at once, lane state is word-major as in SHA_MultiBuffer
+    template <bool NODE>
+    static void hashLanes(const std::size_t L, const DigType* child, DigType* parent) {
+        static const std::size_t MAX_LANES = SHA_256_Lanes::MAX_LANES;
+
+        alignas(64) std::array<std::uint32_t, 8 * MAX_LANES> H;
+        alignas(64) std::array<std::uint32_t, 16 * MAX_LANES> W;
+
+        const auto& H0 = IV<NODE>();
+
+        for (std::size_t j = 0; j < L; ++j) {
+            for (std::size_t i = 0; i < 8; ++i) {
+                H[i * L + j] = H0[i];
+                W[i * L + j] = child[2 * j][i];
+                W[(i + 8) * L + j] = child[2 * j + 1][i];
+            }
+        }
+
+        SHA_256_Lanes::compress(L, H.data(), W.data(), SHA_256_K::values().data());
+        SHA_256_Lanes::compressScheduled(L, H.data(), padKW<NODE>());
+
+        for (std::size_t j = 0; j < L; ++j) {
+            for (std::size_t i = 0; i < 8; ++i) {
+                parent[j][i] = H[i * L + j];
+            }
+        }
+    }
+};
+
+} // namespace cryptl
+
+#endif
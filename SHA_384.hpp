@@ -9,12 +9,34 @@
 
 namespace cryptl {
 
+////////////////////////////////////////////////////////////////////////////////
+// SHA-384 constant words
+//
+
+class SHA_384_IV
+{
+public:
+    typedef std::array<std::uint64_t, 8> ArrayType;
+
+    // initial hash value (NIST FIPS 180-4 section 5.3.4)
+    static const ArrayType& values() {
+        static constexpr ArrayType a {
+            0xcbbb9d5dc1059ed8, 0x629a292a367cd507,
+            0x9159015a3070dd17, 0x152fecd8f70e5939,
+
+            0x67332667ffc00b31, 0x8eb44a8768581511,
+            0xdb0c2e0d64f98fa7, 0x47b5481dbefa4fa4 };
+
+        return a;
+    }
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 // SHA-384
 //
 
 template <typename T, typename MSG, typename U, typename F>
-class SHA_384 : public SHA_512<T, MSG, U, F>
+class SHA_384 : public SHA_512<T, MSG, U, F, SHA_384<T, MSG, U, F>>
 {
 public:
     typedef T WordType;
@@ -42,21 +64,16 @@ public:
     }
 
     // overrides base class SHA-512
-    virtual void initHashValue() {
+    void initHashValue() {
         // set initial hash value (NIST FIPS 180-4 section 5.3.4)
-        const std::array<uint64_t, 8> a {
-            0xcbbb9d5dc1059ed8, 0x629a292a367cd507,
-            0x9159015a3070dd17, 0x152fecd8f70e5939,
-
-            0x67332667ffc00b31, 0x8eb44a8768581511,
-            0xdb0c2e0d64f98fa7, 0x47b5481dbefa4fa4 };
+        const auto& a = SHA_384_IV::values();
 
         for (std::size_t i = 0; i < 8; ++i) {
             this->m_H[i] = F::constant(a[i]);
         }
     }
 
-    virtual void afterHash() {
+    void afterHash() {
         m_setDigest = true;
     }
 
@@ -6,15 +6,144 @@
 
 #include <cryptl/BitwiseINT.hpp>
 #include <cryptl/SHA.hpp>
+#include <cryptl/SHA_Unrolled.hpp>
 
 namespace cryptl {
 
+////////////////////////////////////////////////////////////////////////////////
+// SHA-512 constant words
+//
+
+class SHA_512_IV
+{
+public:
+    typedef std::array<std::uint64_t, 8> ArrayType;
+
+    // initial hash value (NIST FIPS 180-4 section 5.3.5)
+    static const ArrayType& values() {
+        static constexpr ArrayType a {
+            0x6a09e667f3bcc908, 0xbb67ae8584caa73b,
+            0x3c6ef372fe94f82b, 0xa54ff53a5f1d36f1,
+
+            0x510e527fade682d1, 0x9b05688c2b3e6c1f,
+            0x1f83d9abfb41bd6b, 0x5be0cd19137e2179 };
+
+        return a;
+    }
+};
+
+class SHA_512_K
+{
+public:
+    typedef std::array<std::uint64_t, 80> ArrayType;
+
+    // constants (NIST FIPS 180-4 section 4.2.3)
+    static const ArrayType& values() {
+        static constexpr ArrayType a {
+            0x428a2f98d728ae22, 0x7137449123ef65cd,
+            0xb5c0fbcfec4d3b2f, 0xe9b5dba58189dbbc,
+
+            0x3956c25bf348b538, 0x59f111f1b605d019,
+            0x923f82a4af194f9b, 0xab1c5ed5da6d8118,
+
+            0xd807aa98a3030242, 0x12835b0145706fbe,
+            0x243185be4ee4b28c, 0x550c7dc3d5ffb4e2,
+
+            0x72be5d74f27b896f, 0x80deb1fe3b1696b1,
+            0x9bdc06a725c71235, 0xc19bf174cf692694,
+
+            0xe49b69c19ef14ad2, 0xefbe4786384f25e3,
+            0x0fc19dc68b8cd5b5, 0x240ca1cc77ac9c65,
+
+            0x2de92c6f592b0275, 0x4a7484aa6ea6e483,
+            0x5cb0a9dcbd41fbd4, 0x76f988da831153b5,
+
+            0x983e5152ee66dfab, 0xa831c66d2db43210,
+            0xb00327c898fb213f, 0xbf597fc7beef0ee4,
+
+            0xc6e00bf33da88fc2, 0xd5a79147930aa725,
+            0x06ca6351e003826f, 0x142929670a0e6e70,
+
+            0x27b70a8546d22ffc, 0x2e1b21385c26c926,
+            0x4d2c6dfc5ac42aed, 0x53380d139d95b3df,
+
+            0x650a73548baf63de, 0x766a0abb3c77b2a8,
+            0x81c2c92e47edaee6, 0x92722c851482353b,
+
+            0xa2bfe8a14cf10364, 0xa81a664bbc423001,
+            0xc24b8b70d0f89791, 0xc76c51a30654be30,
+
+            0xd192e819d6ef5218, 0xd69906245565a910,
+            0xf40e35855771202a, 0x106aa07032bbd1b8,
+
+            0x19a4c116b8d2d0c8, 0x1e376c085141ab53,
+            0x2748774cdf8eeb99, 0x34b0bcb5e19b48a8,
+
+            0x391c0cb3c5c95a63, 0x4ed8aa4ae3418acb,
+            0x5b9cca4f7763e373, 0x682e6ff3d6b2b8a3,
+
+            0x748f82ee5defb2fc, 0x78a5636f43172f60,
+            0x84c87814a1f0ab72, 0x8cc702081a6439ec,
+
+            0x90befffa23631e28, 0xa4506cebde82bde9,
+            0xbef9a3f7b2c67915, 0xc67178f2e372532b,
+
+            0xca273eceea26619c, 0xd186b8c721c0c207,
+            0xeada7dd6cde0eb1e, 0xf57d4f7fee6ed178,
+
+            0x06f067aa72176fba, 0x0a637dc5a2c898a6,
+            0x113f9804bef90dae, 0x1b710b35131c471b,
+
+            0x28db77f523047d84, 0x32caab7b40c72493,
+            0x3c9ebe0a15c9bebc, 0x431d67c49c100d4c,
+
+            0x4cc5d4becb3e42b6, 0x597f299cfc657e2a,
+            0x5fcb6fab3ad6faec, 0x6c44198c4a475817 };
+
+        return a;
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// fast compression for unmanaged 64-bit words, unrolled portable code
+//
+
+template <typename T, typename MSG, typename F>
+class SHA_512_Accel
+{
+public:
+    static bool enabled() { return false; }
+
+    static void compress(std::array<T, 8>&, const MSG*) {
+    }
+};
+
+template <>
+class SHA_512_Accel<std::uint64_t,
+                    std::uint64_t,
+                    SHA_Functions<std::uint64_t,
+                                  std::uint64_t,
+                                  BitwiseINT<std::uint64_t>>>
+{
+public:
+    static bool enabled() { return true; }
+
+    static void compress(std::array<std::uint64_t, 8>& H,
+                         const std::uint64_t* M) {
+        SHA_512_Unrolled::compress(H.data(), M, SHA_512_K::values().data());
+    }
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 // SHA-512
 //
 
-template <typename T, typename MSG, typename U, typename F>
-class SHA_512 : public SHA_Base<SHA_512<T, MSG, U, F>,
+template <typename T,
+          typename MSG,
+          typename U,
+          typename F,
+          typename DERIVED = void>
+class SHA_512 : public SHA_Base<SHA_CRTP<SHA_512<T, MSG, U, F>, DERIVED>,
                                 SHA_BlockSize::BLOCK_1024,
                                 MSG>
 {
@@ -24,34 +153,70 @@ public:
 
     typedef std::array<T, 16> MsgType;
     typedef std::array<T, 8> DigType;
+    typedef SHA_Midstate<T, 8> MidType;
     typedef std::array<U, 16 * 8> PreType;
 
-    SHA_512() {
-        initConstants();
-    }
-
     const std::array<T, 8>& digest() const {
         return m_H;
     }
 
-    virtual void initHashValue() {
-        // set initial hash value (NIST FIPS 180-4 section 5.3.5)
-        const std::array<std::uint64_t, 8> a {
-            0x6a09e667f3bcc908, 0xbb67ae8584caa73b,
-            0x3c6ef372fe94f82b, 0xa54ff53a5f1d36f1,
+    // streamed hash value and message length, only at a block boundary
+    MidType midstate() const {
+        MidType a;
+        a.H = m_H;
+        a.lengthBits = this->streamLengthBits();
+        return a;
+    }
 
-            0x510e527fade682d1, 0x9b05688c2b3e6c1f,
-            0x1f83d9abfb41bd6b, 0x5be0cd19137e2179 };
+    // continue streaming from a midstate instead of initHash()
+    void resumeHash(const MidType& a) {
+        m_H = a.H;
+        this->streamResume(a.lengthBits);
+    }
+
+    // only the intermediate hash value, see fork()
+    void forkHash(const SHA_512& other) {
+        m_H = other.m_H;
+    }
+
+    // chaining value of the full blocks in computeHashAppended()
+    void saveChain() {
+        m_chainH = m_H;
+    }
+
+    void restoreChain() {
+        m_H = m_chainH;
+    }
+
+    // see wipeHash()
+    void wipeState() {
+        wipeIfPlain(m_W);
+        wipeIfPlain(m_H);
+        wipeIfPlain(m_chainH);
+        wipeIfPlain(m_T);
+        wipeIfPlain(m_a);
+        wipeIfPlain(m_b);
+        wipeIfPlain(m_c);
+        wipeIfPlain(m_d);
+        wipeIfPlain(m_e);
+        wipeIfPlain(m_f);
+        wipeIfPlain(m_g);
+        wipeIfPlain(m_h);
+    }
+
+    void initHashValue() {
+        // set initial hash value (NIST FIPS 180-4 section 5.3.5)
+        const auto& a = SHA_512_IV::values();
 
         for (std::size_t i = 0; i < 8; ++i) {
             m_H[i] = F::constant(a[i]);
         }
     }
 
-    void prepMsgSchedule(std::size_t& msgIndex) {
+    void prepMsgSchedule(MSG* M) {
         // prepare message schedule (NIST FIPS 180-4 section 6.4.2)
         for (std::size_t i = 0; i < 16; ++i) {
-            m_W[i] = this->msgWord(msgIndex);
+            m_W[i] = M[i];
         }
 
         for (std::size_t i = 16; i < 80; ++i) {
@@ -124,83 +289,28 @@ public:
         m_H[7] = F::ADDMOD(m_H[7], m_h);
     }
 
-    virtual void afterHash() {
+    void afterHash() {
     }
 
-protected:
-    void initConstants() {
-        // set constants (NIST FIPS 180-4 section 4.2.3)
-        const std::array<std::uint64_t, 80> a {
-            0x428a2f98d728ae22, 0x7137449123ef65cd,
-            0xb5c0fbcfec4d3b2f, 0xe9b5dba58189dbbc,
-
-            0x3956c25bf348b538, 0x59f111f1b605d019,
-            0x923f82a4af194f9b, 0xab1c5ed5da6d8118,
-
-            0xd807aa98a3030242, 0x12835b0145706fbe,
-            0x243185be4ee4b28c, 0x550c7dc3d5ffb4e2,
-
-            0x72be5d74f27b896f, 0x80deb1fe3b1696b1,
-            0x9bdc06a725c71235, 0xc19bf174cf692694,
+    // hides base class, fast compression for unmanaged words
+    void compressBlock(MSG* M) {
+        typedef SHA_512_Accel<T, MSG, F> Accel;
 
-            0xe49b69c19ef14ad2, 0xefbe4786384f25e3,
-            0x0fc19dc68b8cd5b5, 0x240ca1cc77ac9c65,
-
-            0x2de92c6f592b0275, 0x4a7484aa6ea6e483,
-            0x5cb0a9dcbd41fbd4, 0x76f988da831153b5,
-
-            0x983e5152ee66dfab, 0xa831c66d2db43210,
-            0xb00327c898fb213f, 0xbf597fc7beef0ee4,
-
-            0xc6e00bf33da88fc2, 0xd5a79147930aa725,
-            0x06ca6351e003826f, 0x142929670a0e6e70,
-
-            0x27b70a8546d22ffc, 0x2e1b21385c26c926,
-            0x4d2c6dfc5ac42aed, 0x53380d139d95b3df,
-
-            0x650a73548baf63de, 0x766a0abb3c77b2a8,
-            0x81c2c92e47edaee6, 0x92722c851482353b,
-
-            0xa2bfe8a14cf10364, 0xa81a664bbc423001,
-            0xc24b8b70d0f89791, 0xc76c51a30654be30,
-
-            0xd192e819d6ef5218, 0xd69906245565a910,
-            0xf40e35855771202a, 0x106aa07032bbd1b8,
-
-            0x19a4c116b8d2d0c8, 0x1e376c085141ab53,
-            0x2748774cdf8eeb99, 0x34b0bcb5e19b48a8,
-
-            0x391c0cb3c5c95a63, 0x4ed8aa4ae3418acb,
-            0x5b9cca4f7763e373, 0x682e6ff3d6b2b8a3,
-
-            0x748f82ee5defb2fc, 0x78a5636f43172f60,
-            0x84c87814a1f0ab72, 0x8cc702081a6439ec,
-
-            0x90befffa23631e28, 0xa4506cebde82bde9,
-            0xbef9a3f7b2c67915, 0xc67178f2e372532b,
-
-            0xca273eceea26619c, 0xd186b8c721c0c207,
-            0xeada7dd6cde0eb1e, 0xf57d4f7fee6ed178,
-
-            0x06f067aa72176fba, 0x0a637dc5a2c898a6,
-            0x113f9804bef90dae, 0x1b710b35131c471b,
-
-            0x28db77f523047d84, 0x32caab7b40c72493,
-            0x3c9ebe0a15c9bebc, 0x431d67c49c100d4c,
-
-            0x4cc5d4becb3e42b6, 0x597f299cfc657e2a,
-            0x5fcb6fab3ad6faec, 0x6c44198c4a475817 };
-
-        for (std::size_t i = 0; i < 80; ++i) {
-            m_K[i] = F::constant(a[i]);
+        if (Accel::enabled()) {
+            Accel::compress(m_H, M);
+        } else {
+            SHA_Base<SHA_CRTP<SHA_512<T, MSG, U, F>, DERIVED>,
+                     SHA_BlockSize::BLOCK_1024,
+                     MSG>::compressBlock(M);
         }
     }
 
+protected:
     // eight 64-bit working variables
     T m_a, m_b, m_c, m_d, m_e, m_f, m_g, m_h;
 
     // 80 constant 64-bit words
-    std::array<T, 80> m_K;
+    SHA_Constants<T, F, SHA_512_K> m_K;
 
     // message schedule of 80 64-bit words
     std::array<T, 80> m_W;
@@ -208,6 +318,9 @@ protected:
     // 512-bit hash value
     std::array<T, 8> m_H;
 
+    // hash value before the padding in computeHashAppended()
+    std::array<T, 8> m_chainH;
+
     // two temporary words
     std::array<T, 2> m_T;
 };
@@ -9,12 +9,34 @@
 
 namespace cryptl {
 
+////////////////////////////////////////////////////////////////////////////////
+// SHA-512/224 constant words
+//
+
+class SHA_512_224_IV
+{
+public:
+    typedef std::array<std::uint64_t, 8> ArrayType;
+
+    // initial hash value (NIST FIPS 180-4 section 5.3.6.1)
+    static const ArrayType& values() {
+        static constexpr ArrayType a {
+            0x8C3D37C819544DA2, 0x73E1996689DCD4D6,
+            0x1DFAB7AE32FF9C82, 0x679DD514582F9FCF,
+
+            0x0F6D2B697BD44DA8, 0x77E36F7304C48942,
+            0x3F9D85A86A1D36C8, 0x1112E6AD91D692A1 };
+
+        return a;
+    }
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 // SHA-512/224
 //
 
 template <typename H, typename T, typename MSG, typename U, typename F, typename X>
-class SHA_512_224 : public SHA_512<T, MSG, U, F>
+class SHA_512_224 : public SHA_512<T, MSG, U, F, SHA_512_224<H, T, MSG, U, F, X>>
 {
 public:
     typedef T WordType;
@@ -60,21 +82,16 @@ public:
     }
 
     // overrides base class SHA-512
-    virtual void initHashValue() {
+    void initHashValue() {
         // set initial hash value (NIST FIPS 180-4 section 5.3.6.1)
-        const std::array<std::uint64_t, 8> a {
-            0x8C3D37C819544DA2, 0x73E1996689DCD4D6,
-            0x1DFAB7AE32FF9C82, 0x679DD514582F9FCF,
-
-            0x0F6D2B697BD44DA8, 0x77E36F7304C48942,
-            0x3F9D85A86A1D36C8, 0x1112E6AD91D692A1 };
+        const auto& a = SHA_512_224_IV::values();
 
         for (std::size_t i = 0; i < 8; ++i) {
             this->m_H[i] = F::constant(a[i]);
         }
     }
 
-    virtual void afterHash() {
+    void afterHash() {
         m_setDigest = true;
     }
 
@@ -9,12 +9,34 @@
 
 namespace cryptl {
 
+////////////////////////////////////////////////////////////////////////////////
+// SHA-512/256 constant words
+//
+
+class SHA_512_256_IV
+{
+public:
+    typedef std::array<std::uint64_t, 8> ArrayType;
+
+    // initial hash value (NIST FIPS 180-4 section 5.3.6.2)
+    static const ArrayType& values() {
+        static constexpr ArrayType a {
+            0x22312194FC2BF72C, 0x9F555FA3C84C64C2,
+            0x2393B86B6F53B151, 0x963877195940EABD,
+
+            0x96283EE2A88EFFE3, 0xBE5E1E2553863992,
+            0x2B0199FC2C85B8AA, 0x0EB72DDC81C52CA2 };
+
+        return a;
+    }
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 // SHA-512/256
 //
 
 template <typename H, typename T, typename MSG, typename U, typename F, typename X>
-class SHA_512_256 : public SHA_512<T, MSG, U, F>
+class SHA_512_256 : public SHA_512<T, MSG, U, F, SHA_512_256<H, T, MSG, U, F, X>>
 {
 public:
     typedef T WordType;
@@ -53,26 +75,21 @@ public:
         return m_Hleft256;
     }
 
-    virtual void afterHash() {
-        m_setDigest = true;
-    }
-
-protected:
     // overrides base class SHA-512
     void initHashValue() {
         // set initial hash value (NIST FIPS 180-4 section 5.3.6.2)
-        const std::array<std::uint64_t, 8> a {
-            0x22312194FC2BF72C, 0x9F555FA3C84C64C2,
-            0x2393B86B6F53B151, 0x963877195940EABD,
-
-            0x96283EE2A88EFFE3, 0xBE5E1E2553863992,
-            0x2B0199FC2C85B8AA, 0x0EB72DDC81C52CA2 };
+        const auto& a = SHA_512_256_IV::values();
 
         for (std::size_t i = 0; i < 8; ++i) {
             this->m_H[i] = F::constant(a[i]);
         }
     }
 
+    void afterHash() {
+        m_setDigest = true;
+    }
+
+protected:
     // truncated 256-bit message digest
     std::array<H, 8> m_Hleft256;
 
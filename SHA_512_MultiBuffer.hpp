@@ -0,0 +1,215 @@
+#ifndef _CRYPTL_SHA_512_MULTI_BUFFER_HPP_
+#define _CRYPTL_SHA_512_MULTI_BUFFER_HPP_
+
+#include <cstdint>
+
+#include <cryptl/CPU_Features.hpp>
+#include <cryptl/SHA_384.hpp>
+#include <cryptl/SHA_512.hpp>
+#include <cryptl/SHA_512_224.hpp>
+#include <cryptl/SHA_512_256.hpp>
+#include <cryptl/SHA_MultiBuffer.hpp>
+
+#ifdef CRYPTL_X86_64
+#include <immintrin.h>
+#endif
+
+namespace cryptl {
+
+////////////////////////////////////////////////////////////////////////////////
+// SHA-512 compression of 4 (AVX2) or 8 (AVX-512) messages at once
+//
+// H is 8 words by L lanes, W is 16 words by L lanes, K is the 80 round
+// constants. Lane j of word i is at index i * L + j.
+//
+
+class SHA_512_Lanes
+{
+public:
+    static const std::size_t MAX_LANES = 8;
+
+    // zero if there are no suitable SIMD extensions
+    static std::size_t lanes() {
+        return CPU_Features::hasAVX512() ? 8 : CPU_Features::hasAVX2() ? 4 : 0;
+    }
+
+#ifdef CRYPTL_X86_64
+    static void compress(const std::size_t L,
+                         std::uint64_t* H,
+                         const std::uint64_t* W,
+                         const std::uint64_t* K) {
+        if (8 == L)
+            compress8(H, W, K);
+        else
+            compress4(H, W, K);
+    }
+#else
+    static void compress(const std::size_t,
+                         std::uint64_t*,
+                         const std::uint64_t*,
+                         const std::uint64_t*) {
+    }
+#endif
+
+#ifdef CRYPTL_X86_64
+private:
+    // AVX2, four lanes
+    __attribute__((target("avx2")))
+    static __m256i ROTR(const __m256i x, const int n) {
+        return _mm256_or_si256(_mm256_srli_epi64(x, n), _mm256_slli_epi64(x, 64 - n));
+    }
+
+    __attribute__((target("avx2")))
+    static __m256i XOR3(const __m256i x, const __m256i y, const __m256i z) {
+        return _mm256_xor_si256(_mm256_xor_si256(x, y), z);
+    }
+
+    __attribute__((target("avx2")))
+    static void compress4(std::uint64_t* H,
+                          const std::uint64_t* M,
+                          const std::uint64_t* K)
+    {
+        __m256i V[8];
+        for (std::size_t i = 0; i < 8; ++i)
+            V[i] = _mm256_load_si256(reinterpret_cast<const __m256i*>(H + 4*i));
+
+        __m256i a = V[0], b = V[1], c = V[2], d = V[3],
+                e = V[4], f = V[5], g = V[6], h = V[7];
+
+        // message schedule in a rolling window of sixteen words
+        __m256i W[16];
+
+#pragma GCC unroll 80
+        for (std::size_t i = 0; i < 80; ++i) {
+            if (i < 16) {
+                W[i] = _mm256_load_si256(reinterpret_cast<const __m256i*>(M + 4*i));
+            } else {
+                const __m256i w2 = W[(i - 2) % 16], w15 = W[(i - 15) % 16];
+                const __m256i s1 = XOR3(ROTR(w2, 19), ROTR(w2, 61), _mm256_srli_epi64(w2, 6));
+                const __m256i s0 = XOR3(ROTR(w15, 1), ROTR(w15, 8), _mm256_srli_epi64(w15, 7));
+                W[i % 16] = _mm256_add_epi64(
+                    _mm256_add_epi64(s1, W[(i - 7) % 16]),
+                    _mm256_add_epi64(s0, W[i % 16]));
+            }
+
+            // T1 = h + SIGMA_512_1(e) + Ch(e, f, g) + K[i] + W[i]
+            const __m256i ch = _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g));
+            const __m256i T1 = _mm256_add_epi64(
+                _mm256_add_epi64(h, XOR3(ROTR(e, 14), ROTR(e, 18), ROTR(e, 41))),
+                _mm256_add_epi64(
+                    _mm256_add_epi64(ch, _mm256_set1_epi64x(K[i])),
+                    W[i % 16]));
+
+            // T2 = SIGMA_512_0(a) + Maj(a, b, c)
+            const __m256i maj = XOR3(_mm256_and_si256(a, b), _mm256_and_si256(a, c), _mm256_and_si256(b, c));
+            const __m256i T2 = _mm256_add_epi64(XOR3(ROTR(a, 28), ROTR(a, 34), ROTR(a, 39)), maj);
+
+            h = g;
+            g = f;
+            f = e;
+            e = _mm256_add_epi64(d, T1);
+            d = c;
+            c = b;
+            b = a;
+            a = _mm256_add_epi64(T1, T2);
+        }
+
+        V[0] = _mm256_add_epi64(V[0], a);
+        V[1] = _mm256_add_epi64(V[1], b);
+        V[2] = _mm256_add_epi64(V[2], c);
+        V[3] = _mm256_add_epi64(V[3], d);
+        V[4] = _mm256_add_epi64(V[4], e);
+        V[5] = _mm256_add_epi64(V[5], f);
+        V[6] = _mm256_add_epi64(V[6], g);
+        V[7] = _mm256_add_epi64(V[7], h);
+
+        for (std::size_t i = 0; i < 8; ++i)
+            _mm256_store_si256(reinterpret_cast<__m256i*>(H + 4*i), V[i]);
+    }
+
+    // AVX-512, eight lanes
+    __attribute__((target("avx512f")))
+    static __m512i XOR3(const __m512i x, const __m512i y, const __m512i z) {
+        return _mm512_ternarylogic_epi64(x, y, z, 0x96);
+    }
+
+    __attribute__((target("avx512f")))
+    static void compress8(std::uint64_t* H,
+                          const std::uint64_t* M,
+                          const std::uint64_t* K)
+    {
+        __m512i V[8];
+        for (std::size_t i = 0; i < 8; ++i)
+            V[i] = _mm512_load_si512(H + 8*i);
+
+        __m512i a = V[0], b = V[1], c = V[2], d = V[3],
+                e = V[4], f = V[5], g = V[6], h = V[7];
+
+        // message schedule in a rolling window of sixteen words
+        __m512i W[16];
+
+#pragma GCC unroll 80
+        for (std::size_t i = 0; i < 80; ++i) {
+            if (i < 16) {
+                W[i] = _mm512_load_si512(M + 8*i);
+            } else {
+                const __m512i w2 = W[(i - 2) % 16], w15 = W[(i - 15) % 16];
+                const __m512i s1 = XOR3(_mm512_ror_epi64(w2, 19), _mm512_ror_epi64(w2, 61), _mm512_srli_epi64(w2, 6));
+                const __m512i s0 = XOR3(_mm512_ror_epi64(w15, 1), _mm512_ror_epi64(w15, 8), _mm512_srli_epi64(w15, 7));
+                W[i % 16] = _mm512_add_epi64(
+                    _mm512_add_epi64(s1, W[(i - 7) % 16]),
+                    _mm512_add_epi64(s0, W[i % 16]));
+            }
+
+            // T1 = h + SIGMA_512_1(e) + Ch(e, f, g) + K[i] + W[i]
+            const __m512i ch = _mm512_ternarylogic_epi64(e, f, g, 0xca);
+            const __m512i T1 = _mm512_add_epi64(
+                _mm512_add_epi64(h, XOR3(_mm512_ror_epi64(e, 14), _mm512_ror_epi64(e, 18), _mm512_ror_epi64(e, 41))),
+                _mm512_add_epi64(
+                    _mm512_add_epi64(ch, _mm512_set1_epi64(K[i])),
+                    W[i % 16]));
+
+            // T2 = SIGMA_512_0(a) + Maj(a, b, c)
+            const __m512i maj = _mm512_ternarylogic_epi64(a, b, c, 0xe8);
+            const __m512i T2 = _mm512_add_epi64(XOR3(_mm512_ror_epi64(a, 28), _mm512_ror_epi64(a, 34), _mm512_ror_epi64(a, 39)), maj);
+
+            h = g;
+            g = f;
+            f = e;
+            e = _mm512_add_epi64(d, T1);
+            d = c;
+            c = b;
+            b = a;
+            a = _mm512_add_epi64(T1, T2);
+        }
+
+        V[0] = _mm512_add_epi64(V[0], a);
+        V[1] = _mm512_add_epi64(V[1], b);
+        V[2] = _mm512_add_epi64(V[2], c);
+        V[3] = _mm512_add_epi64(V[3], d);
+        V[4] = _mm512_add_epi64(V[4], e);
+        V[5] = _mm512_add_epi64(V[5], f);
+        V[6] = _mm512_add_epi64(V[6], g);
+        V[7] = _mm512_add_epi64(V[7], h);
+
+        for (std::size_t i = 0; i < 8; ++i)
+            _mm512_store_si512(H + 8*i, V[i]);
+    }
+#endif
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// typedefs
+//
+
+typedef SHA_MultiBuffer<SHA512, SHA_512_Lanes> SHA512_MultiBuffer;
+
+typedef SHA_MultiBuffer<SHA384, SHA_512_Lanes> SHA384_MultiBuffer;
+
+typedef SHA_MultiBuffer<SHA512_224, SHA_512_Lanes> SHA512_224_MultiBuffer;
+
+typedef SHA_MultiBuffer<SHA512_256, SHA_512_Lanes> SHA512_256_MultiBuffer;
+
+} // namespace cryptl
+
+#endif
@@ -0,0 +1,225 @@
+#ifndef _CRYPTL_SHA_MULTI_BUFFER_HPP_
+#define _CRYPTL_SHA_MULTI_BUFFER_HPP_
+
+#include <array>
+#include <climits>
+#include <cstdint>
+#include <vector>
+
+#include <cryptl/Bless.hpp>
+#include <cryptl/Digest.hpp>
+
+namespace cryptl {
+
+////////////////////////////////////////////////////////////////////////////////
+// no SIMD compression function (e.g. SHA-1), always one message at a time
+//
+
+class SHA_NoLanes
+{
+public:
+    static const std::size_t MAX_LANES = 1;
+
+    static std::size_t lanes() {
+        return 0;
+    }
+
+    template <typename W>
+    static void compress(const std::size_t, W*, const W*, const W*) {
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// multi-buffer SHA for batches of independent messages
+//
+// T is the SHA typedef, LANES is the SIMD compression function. Each lane
+// hashes a different message. When a message is finished, its lane is
+// refilled with the next message from the queue. If the processor has no
+// suitable SIMD extensions, messages are hashed one at a time.
+//
+
+template <typename T, typename LANES>
+class SHA_MultiBuffer
+{
+public:
+    typedef typename T::WordType WordType;
+    typedef typename T::DigType DigType;
+
+    SHA_MultiBuffer() = default;
+
+    // digests in the same order as the messages
+    void digest(const std::uint8_t* const* msg,
+                const std::size_t* len,
+                const std::size_t N,
+                DigType* out) const
+    {
+        const std::size_t L = LANES::lanes();
+
+        if (0 == L) {
+            for (std::size_t i = 0; i < N; ++i)
+                out[i] = cryptl::digest(T(), msg[i], len[i]);
+
+            return;
+        }
+
+        AlgoState algo;
+
+        // lane state is word-major: H[8 * MAX_LANES], W[16 * MAX_LANES]
+        alignas(64) std::array<WordType, 8 * MAX_LANES> H;
+        alignas(64) std::array<WordType, 16 * MAX_LANES> W;
+        std::array<Lane, MAX_LANES> lanes;
+        W.fill(0);
+
+        std::size_t next = 0, active = 0;
+        for (std::size_t j = 0; j < L; ++j) {
+            if (next < N) {
+                startLane(lanes[j], H, L, j, algo, next, msg[next], len[next]);
+                ++next;
+                ++active;
+            } else {
+                lanes[j].active = false;
+            }
+        }
+
+        while (0 != active) {
+            for (std::size_t j = 0; j < L; ++j) {
+                if (lanes[j].active) loadBlock(lanes[j], W, L, j);
+            }
+
+            LANES::compress(L, H.data(), W.data(), algo.constants());
+
+            for (std::size_t j = 0; j < L; ++j) {
+                Lane& lane = lanes[j];
+                if (! lane.active || ++lane.block != lane.numBlocks) continue;
+
+                out[lane.index] = algo.digestOf(H, L, j);
+
+                if (next < N) {
+                    startLane(lane, H, L, j, algo, next, msg[next], len[next]);
+                    ++next;
+                } else {
+                    lane.active = false;
+                    --active;
+                }
+            }
+        }
+    }
+
+    std::vector<DigType> digest(const std::vector<std::vector<std::uint8_t>>& a) const {
+        std::vector<const std::uint8_t*> msg(a.size());
+        std::vector<std::size_t> len(a.size());
+        for (std::size_t i = 0; i < a.size(); ++i) {
+            msg[i] = a[i].data();
+            len[i] = a[i].size();
+        }
+
+        std::vector<DigType> out(a.size());
+        digest(msg.data(), len.data(), a.size(), out.data());
+        return out;
+    }
+
+private:
+    static const std::size_t MAX_LANES = LANES::MAX_LANES;
+    static const std::size_t BLOCK_BYTES = 16 * sizeof(WordType);
+
+    // initial hash value, round constants and digest truncation of T
+    class AlgoState : public T
+    {
+    public:
+        // eight words, or five for SHA-1 which never runs in lanes
+        typedef decltype(T::MidType::H) HashType;
+
+        static const std::size_t HASH_WORDS = std::tuple_size<HashType>::value;
+
+        AlgoState() {
+            this->initHashValue();
+            m_IV = this->m_H;
+        }
+
+        const WordType* constants() const {
+            return this->m_K.data();
+        }
+
+        const HashType& IV() const {
+            return m_IV;
+        }
+
+        DigType digestOf(const std::array<WordType, 8 * MAX_LANES>& H,
+                         const std::size_t L,
+                         const std::size_t lane) {
+            for (std::size_t i = 0; i < HASH_WORDS; ++i)
+                this->m_H[i] = H[i * L + lane];
+
+            this->afterHash();
+            return this->digest();
+        }
+
+    private:
+        HashType m_IV;
+    };
+
+    class Lane
+    {
+    public:
+        bool active;
+        std::size_t index, block, fullBlocks, numBlocks;
+        const std::uint8_t* data;
+
+        // padding at end of message
+        std::array<std::uint8_t, 2 * BLOCK_BYTES> tail;
+    };
+
+    static void startLane(Lane& lane,
+                          std::array<WordType, 8 * MAX_LANES>& H,
+                          const std::size_t L,
+                          const std::size_t j,
+                          const AlgoState& algo,
+                          const std::size_t index,
+                          const std::uint8_t* p,
+                          const std::size_t n)
+    {
+        lane.active = true;
+        lane.index = index;
+        lane.block = 0;
+        lane.data = p;
+        lane.fullBlocks = n / BLOCK_BYTES;
+
+        // remaining bytes, bit "1", zero bits, length of message
+        const std::size_t r = n % BLOCK_BYTES;
+        const std::size_t tailBlocks =
+            r + 1 + 2 * sizeof(WordType) > BLOCK_BYTES ? 2 : 1;
+        lane.numBlocks = lane.fullBlocks + tailBlocks;
+
+        std::size_t k = 0;
+        for (const std::uint8_t* q = p + n - r; k < r; ++k) lane.tail[k] = q[k];
+        lane.tail[k++] = 0x80;
+        while (tailBlocks * BLOCK_BYTES - 8 != k) lane.tail[k++] = 0;
+
+        const std::uint64_t lengthBits = static_cast<std::uint64_t>(n) * CHAR_BIT;
+        for (int i = 7; i >= 0; --i)
+            lane.tail[k++] = (lengthBits >> i * CHAR_BIT) & 0xff;
+
+        for (std::size_t i = 0; i < AlgoState::HASH_WORDS; ++i)
+            H[i * L + j] = algo.IV()[i];
+    }
+
+    // big-endian words of next block transposed into lane
+    static void loadBlock(const Lane& lane,
+                          std::array<WordType, 16 * MAX_LANES>& W,
+                          const std::size_t L,
+                          const std::size_t j)
+    {
+        const std::uint8_t* p =
+            lane.block < lane.fullBlocks
+            ? lane.data + lane.block * BLOCK_BYTES
+            : lane.tail.data() + (lane.block - lane.fullBlocks) * BLOCK_BYTES;
+
+        for (std::size_t i = 0; i < 16; ++i) {
+            blessBigEndian(W[i * L + j], p + i * sizeof(WordType));
+        }
+    }
+};
+
+} // namespace cryptl
+
+#endif
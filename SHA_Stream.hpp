@@ -0,0 +1,180 @@
+#ifndef _CRYPTL_SHA_STREAM_HPP_
+#define _CRYPTL_SHA_STREAM_HPP_
+
+#include <array>
+#include <cassert>
+#include <climits>
+#include <cstdint>
+#include <vector>
+
+#include <cryptl/Bless.hpp>
+#include <cryptl/Wipe.hpp>
+
+namespace cryptl {
+
+////////////////////////////////////////////////////////////////////////////////
+// incremental SHA message digest for data arriving in pieces
+//
+// T is: SHA1, SHA224, SHA256, SHA384, SHA512, SHA512_224, SHA512_256
+//
+// Each message block is compressed as soon as it is full. Memory use is one
+// block of buffered bytes no matter how long the message is. The hash state
+// and buffered bytes are wiped when the stream is destroyed.
+//
+
+template <typename T>
+class SHA_Stream
+{
+public:
+    typedef typename T::WordType WordType;
+    typedef typename T::DigType DigType;
+    typedef typename T::MidType MidType;
+
+    SHA_Stream() {
+        init();
+    }
+
+    explicit SHA_Stream(const T& hashAlgo)
+        : m_hashAlgo(hashAlgo)
+    {
+        init();
+    }
+
+    explicit SHA_Stream(const MidType& a) {
+        init(a);
+    }
+
+    ~SHA_Stream() {
+        wipeHash();
+    }
+
+    void init() {
+        m_hashAlgo.initHash();
+        m_bufferSize = 0;
+        m_lengthBits = 0;
+    }
+
+    // continue from a saved midstate
+    void init(const MidType& a) {
+        m_hashAlgo.resumeHash(a);
+        m_bufferSize = 0;
+        m_lengthBits = a.lengthBits;
+    }
+
+    // only at a block boundary, i.e. message length so far is a multiple
+    // of the block size
+    MidType midstate() const {
+#ifdef USE_ASSERT
+        assert(0 == m_bufferSize);
+#endif
+
+        return m_hashAlgo.midstate();
+    }
+
+    // copy of the stream for another message with the same prefix, only
+    // the hash state in progress and the buffered bytes are copied
+    SHA_Stream fork() const {
+        SHA_Stream a;
+        a.m_hashAlgo.forkFrom(m_hashAlgo);
+        a.m_lengthBits = m_lengthBits;
+
+        for (std::size_t i = 0; i < m_bufferSize; ++i) a.m_buffer[i] = m_buffer[i];
+        a.m_bufferSize = m_bufferSize;
+
+        return a;
+    }
+
+    void update(const std::uint8_t* p, std::size_t n) {
+        m_lengthBits += n * CHAR_BIT;
+
+        // top up partially filled block
+        if (0 != m_bufferSize) {
+            while (0 != n && BLOCK_BYTES != m_bufferSize) {
+                m_buffer[m_bufferSize++] = *p++;
+                --n;
+            }
+
+            if (BLOCK_BYTES != m_bufferSize) return;
+
+            inputBlock(m_buffer.data());
+            m_bufferSize = 0;
+        }
+
+        // whole blocks directly from data
+        while (n >= BLOCK_BYTES) {
+            inputBlock(p);
+            p += BLOCK_BYTES;
+            n -= BLOCK_BYTES;
+        }
+
+        // save remaining bytes for next time
+        while (0 != n) {
+            m_buffer[m_bufferSize++] = *p++;
+            --n;
+        }
+    }
+
+    void update(const std::vector<std::uint8_t>& a) {
+        update(a.data(), a.size());
+    }
+
+    // zero the hash state and buffered bytes, init() again before reuse
+    void wipeHash() {
+        m_hashAlgo.wipeHash();
+        wipe(m_buffer);
+        m_bufferSize = 0;
+    }
+
+    // pads the message, stream must be initialized again before reuse
+    DigType final() {
+        // append bit "1" to end of message
+        m_buffer[m_bufferSize++] = 0x80;
+
+        // length is last two words of the final block
+        const std::size_t stopPadBytes = BLOCK_BYTES - 2 * sizeof(WordType);
+
+        if (m_bufferSize > stopPadBytes) {
+            while (BLOCK_BYTES != m_bufferSize) m_buffer[m_bufferSize++] = 0;
+            inputBlock(m_buffer.data());
+            m_bufferSize = 0;
+        }
+
+        while (BLOCK_BYTES - 8 != m_bufferSize) m_buffer[m_bufferSize++] = 0;
+
+        // append length of message
+        for (int i = 7; i >= 0; --i) {
+            m_buffer[m_bufferSize++] = (m_lengthBits >> i * CHAR_BIT) & 0xff;
+        }
+
+        inputBlock(m_buffer.data());
+        m_bufferSize = 0;
+
+        m_hashAlgo.finalHash();
+        return m_hashAlgo.digest();
+    }
+
+private:
+    static const std::size_t BLOCK_BYTES = 16 * sizeof(WordType);
+
+    // big-endian words
+    void inputBlock(const std::uint8_t* p) {
+        for (std::size_t i = 0; i < 16; ++i) {
+            WordType w;
+            blessBigEndian(w, p + i * sizeof(WordType));
+            m_hashAlgo.streamInput(w);
+        }
+    }
+
+    T m_hashAlgo;
+
+    // partially filled message block
+    std::array<std::uint8_t, 16 * sizeof(WordType)> m_buffer;
+    std::size_t m_bufferSize;
+
+    // message length so far
+    std::uint64_t m_lengthBits;
+};
+
+} // namespace cryptl
+
+#endif
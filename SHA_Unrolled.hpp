@@ -0,0 +1,205 @@
+#ifndef _CRYPTL_SHA_UNROLLED_HPP_
+#define _CRYPTL_SHA_UNROLLED_HPP_
+
+#include <cstdint>
+
+#include <cryptl/BitwiseINT.hpp>
+#include <cryptl/SHA.hpp>
+
+namespace cryptl {
+
+////////////////////////////////////////////////////////////////////////////////
+// SHA compression for built-in integer words, portable C++
+//
+// H is the hash value, M is one block of sixteen message words (already
+// big-endian decoded), K is the round constants. All rounds are unrolled so
+// the working variables stay in registers and the round functions are fixed
+// at compile time. The message schedule is a rolling window of sixteen words.
+//
+
+class SHA_1_Unrolled
+{
+public:
+    static void compress(std::uint32_t* H,
+                         const std::uint32_t* M,
+                         const std::uint32_t* K)
+    {
+        typedef SHA_Functions<std::uint32_t,
+                              std::uint32_t,
+                              BitwiseINT<std::uint32_t>> F;
+
+        std::uint32_t a = H[0], b = H[1], c = H[2], d = H[3], e = H[4];
+
+        std::uint32_t W[16];
+
+        // (NIST FIPS 180-4 section 6.1.2)
+#pragma GCC unroll 80
+        for (std::size_t i = 0; i < 80; ++i) {
+            if (i < 16) {
+                W[i] = M[i];
+            } else {
+                W[i % 16] = F::ROTL(W[(i - 3) % 16] ^ W[(i - 8) % 16] ^
+                                    W[(i - 14) % 16] ^ W[i % 16],
+                                    1);
+            }
+
+            const std::uint32_t T =
+                F::ROTL(a, 5) + F::f(b, c, d, i) + e + K[i / 20] + W[i % 16];
+
+            e = d;
+            d = c;
+            c = F::ROTL(b, 30);
+            b = a;
+            a = T;
+        }
+
+        H[0] += a;
+        H[1] += b;
+        H[2] += c;
+        H[3] += d;
+        H[4] += e;
+    }
+};
+
+class SHA_256_Unrolled
+{
+public:
+    static void compress(std::uint32_t* H,
+                         const std::uint32_t* M,
+                         const std::uint32_t* K)
+    {
+        typedef SHA_Functions<std::uint32_t,
+                              std::uint32_t,
+                              BitwiseINT<std::uint32_t>> F;
+
+        std::uint32_t a = H[0], b = H[1], c = H[2], d = H[3],
+                      e = H[4], f = H[5], g = H[6], h = H[7];
+
+        std::uint32_t W[16];
+
+        // (NIST FIPS 180-4 section 6.2.2)
+#pragma GCC unroll 64
+        for (std::size_t i = 0; i < 64; ++i) {
+            if (i < 16) {
+                W[i] = M[i];
+            } else {
+                W[i % 16] += F::sigma_256_1(W[(i - 2) % 16]) + W[(i - 7) % 16] +
+                             F::sigma_256_0(W[(i - 15) % 16]);
+            }
+
+            const std::uint32_t
+                T1 = h + F::SIGMA_256_1(e) + F::Ch(e, f, g) + K[i] + W[i % 16],
+                T2 = F::SIGMA_256_0(a) + F::Maj(a, b, c);
+
+            h = g;
+            g = f;
+            f = e;
+            e = d + T1;
+            d = c;
+            c = b;
+            b = a;
+            a = T1 + T2;
+        }
+
+        H[0] += a;
+        H[1] += b;
+        H[2] += c;
+        H[3] += d;
+        H[4] += e;
+        H[5] += f;
+        H[6] += g;
+        H[7] += h;
+    }
+
+    // no message, KW is the round constants plus the message schedule of
+    // a block known in advance (e.g. padding only)
+    static void compressScheduled(std::uint32_t* H, const std::uint32_t* KW)
+    {
+        typedef SHA_Functions<std::uint32_t,
+                              std::uint32_t,
+                              BitwiseINT<std::uint32_t>> F;
+
+        std::uint32_t a = H[0], b = H[1], c = H[2], d = H[3],
+                      e = H[4], f = H[5], g = H[6], h = H[7];
+
+#pragma GCC unroll 64
+        for (std::size_t i = 0; i < 64; ++i) {
+            const std::uint32_t
+                T1 = h + F::SIGMA_256_1(e) + F::Ch(e, f, g) + KW[i],
+                T2 = F::SIGMA_256_0(a) + F::Maj(a, b, c);
+
+            h = g;
+            g = f;
+            f = e;
+            e = d + T1;
+            d = c;
+            c = b;
+            b = a;
+            a = T1 + T2;
+        }
+
+        H[0] += a;
+        H[1] += b;
+        H[2] += c;
+        H[3] += d;
+        H[4] += e;
+        H[5] += f;
+        H[6] += g;
+        H[7] += h;
+    }
+};
+
+class SHA_512_Unrolled
+{
+public:
+    static void compress(std::uint64_t* H,
+                         const std::uint64_t* M,
+                         const std::uint64_t* K)
+    {
+        typedef SHA_Functions<std::uint64_t,
+                              std::uint64_t,
+                              BitwiseINT<std::uint64_t>> F;
+
+        std::uint64_t a = H[0], b = H[1], c = H[2], d = H[3],
+                      e = H[4], f = H[5], g = H[6], h = H[7];
+
+        std::uint64_t W[16];
+
+        // (NIST FIPS 180-4 section 6.4.2)
+#pragma GCC unroll 80
+        for (std::size_t i = 0; i < 80; ++i) {
+            if (i < 16) {
+                W[i] = M[i];
+            } else {
+                W[i % 16] += F::sigma_512_1(W[(i - 2) % 16]) + W[(i - 7) % 16] +
+                             F::sigma_512_0(W[(i - 15) % 16]);
+            }
+
+            const std::uint64_t
+                T1 = h + F::SIGMA_512_1(e) + F::Ch(e, f, g) + K[i] + W[i % 16],
+                T2 = F::SIGMA_512_0(a) + F::Maj(a, b, c);
+
+            h = g;
+            g = f;
+            f = e;
+            e = d + T1;
+            d = c;
+            c = b;
+            b = a;
+            a = T1 + T2;
+        }
+
+        H[0] += a;
+        H[1] += b;
+        H[2] += c;
+        H[3] += d;
+        H[4] += e;
+        H[5] += f;
+        H[6] += g;
+        H[7] += h;
+    }
+};
+
+} // namespace cryptl
+
+#endif
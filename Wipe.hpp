@@ -0,0 +1,70 @@
+#ifndef _CRYPTL_WIPE_HPP_
+#define _CRYPTL_WIPE_HPP_
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace cryptl {
+
+////////////////////////////////////////////////////////////////////////////////
+// wiping (erase secret variables)
+//
+// Zeroing a buffer just before it goes out of scope is a dead store, the
+// optimizer may remove it. With GCC and Clang an empty asm statement that
+// may read the memory keeps the memset. Other compilers write through a
+// volatile pointer.
+//
+
+inline void wipe(void* p, const std::size_t n) {
+#if defined(__GNUC__)
+    std::memset(p, 0, n);
+    __asm__ __volatile__ ("" : : "r" (p) : "memory");
+#else
+    volatile std::uint8_t* v = static_cast<volatile std::uint8_t*>(p);
+    for (std::size_t i = 0; i < n; ++i) v[i] = 0;
+#endif
+}
+
+// arrays, midstates and other plain objects
+template <typename T>
+void wipe(T& a) {
+    static_assert(std::is_trivially_copyable<T>::value && !std::is_pointer<T>::value,
+                  "wipe() object must be plain data");
+
+    wipe(&a, sizeof(T));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// wiping members of templates that also take managed types
+//
+// Plain data is wiped as above. Other types (e.g. variables of a circuit)
+// are left alone.
+//
+
+template <typename T,
+          bool PLAIN = std::is_trivially_copyable<T>::value && !std::is_pointer<T>::value>
+class WipePlain
+{
+public:
+    static void wipe(T&) {
+    }
+};
+
+template <typename T>
+class WipePlain<T, true>
+{
+public:
+    static void wipe(T& a) {
+        cryptl::wipe(a);
+    }
+};
+
+template <typename T>
+void wipeIfPlain(T& a) {
+    WipePlain<T>::wipe(a);
+}
+
+} // namespace cryptl
+
+#endif